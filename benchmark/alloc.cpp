@@ -0,0 +1,142 @@
+// Replaces the global allocator with a counting one, so every benchmark here
+// reports heap allocations and bytes per operation next to its timing. Kept
+// out of bench_executors to leave those timings undisturbed.
+
+#include "common.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations = 0;
+std::atomic<uint64_t> allocated_bytes = 0;
+
+void* CountedAlloc(size_t size, size_t alignment) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr = alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                    ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                    : std::malloc(size);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+    return CountedAlloc(size, 0);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+// Counts allocations made on any thread, workers included, between construction and Report
+class AllocationMeter {
+public:
+    AllocationMeter()
+        : allocations_(allocations.load(std::memory_order_relaxed)),
+          bytes_(allocated_bytes.load(std::memory_order_relaxed)) {
+    }
+
+    void Report(benchmark::State& state, int64_t ops_per_iteration) const {
+        double ops = static_cast<double>(state.iterations() * ops_per_iteration);
+        state.counters["allocs_per_op"] =
+            (allocations.load(std::memory_order_relaxed) - allocations_) / ops;
+        state.counters["bytes_per_op"] =
+            (allocated_bytes.load(std::memory_order_relaxed) - bytes_) / ops;
+    }
+
+private:
+    uint64_t allocations_;
+    uint64_t bytes_;
+};
+
+static void BenchmarkSubmitAllocations(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    AllocationMeter meter;
+    for (auto _ : state) {
+        auto task = std::make_shared<EmptyTask>();
+        executor->Submit(task);
+        task->Wait();
+    }
+    meter.Report(state, 1);
+}
+
+BENCHMARK(BenchmarkSubmitAllocations)->Arg(1)->Arg(4)->ArgName("workers")->UseRealTime();
+
+static void BenchmarkInvokeAllocations(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    AllocationMeter meter;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(executor->Invoke<int>([] { return 42; })->Get());
+    }
+    meter.Report(state, 1);
+}
+
+BENCHMARK(BenchmarkInvokeAllocations)->Arg(1)->Arg(4)->ArgName("workers")->UseRealTime();
+
+// Counted per future in the chain, the leading Invoke included
+static void BenchmarkThenAllocations(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto length = state.range(1);
+    AllocationMeter meter;
+    for (auto _ : state) {
+        auto future = executor->Invoke<int64_t>([] { return int64_t{0}; });
+        for (int64_t i = 0; i < length; ++i) {
+            future = executor->Then<int64_t>(future, [future] { return future->Get() + 1; });
+        }
+        benchmark::DoNotOptimize(future->Get());
+    }
+    meter.Report(state, length + 1);
+}
+
+BENCHMARK(BenchmarkThenAllocations)
+    ->ArgsProduct({{1, 4}, {1, 100}})
+    ->ArgNames({"workers", "length"})
+    ->UseRealTime();
+
+// Counted per joined future, including the width Invokes feeding the join
+static void BenchmarkWhenAllAllocations(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto width = state.range(1);
+    AllocationMeter meter;
+    for (auto _ : state) {
+        std::vector<FuturePtr<int64_t>> all;
+        for (int64_t i = 0; i < width; ++i) {
+            all.push_back(executor->Invoke<int64_t>([i] { return i; }));
+        }
+        benchmark::DoNotOptimize(executor->WhenAll(std::move(all))->Get());
+    }
+    meter.Report(state, width);
+}
+
+BENCHMARK(BenchmarkWhenAllAllocations)
+    ->ArgsProduct({{1, 4}, {1, 10, 1000}})
+    ->ArgNames({"workers", "width"})
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
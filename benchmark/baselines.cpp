@@ -0,0 +1,338 @@
+// The same workloads run on Executor and on the naive alternatives it has to
+// beat: std::async, a thread per task and a trivial mutex-queue pool. Pools are
+// sized to std::thread::hardware_concurrency.
+
+#include "common.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <numeric>
+
+namespace {
+
+class FunctionTask : public Task {
+public:
+    explicit FunctionTask(std::function<void()> fn) : fn_(std::move(fn)) {
+    }
+
+    void Run() override {
+        fn_();
+    }
+
+private:
+    std::function<void()> fn_;
+};
+
+class NaivePool {
+public:
+    explicit NaivePool(size_t threads) {
+        for (size_t i = 0; i < threads; ++i) {
+            threads_.emplace_back([this] {
+                while (true) {
+                    std::unique_lock lock(mutex_);
+                    not_empty_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+                    if (queue_.empty()) {
+                        return;
+                    }
+                    auto fn = std::move(queue_.front());
+                    queue_.pop_front();
+                    lock.unlock();
+                    fn();
+                }
+            });
+        }
+    }
+
+    void Submit(std::function<void()> fn) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(std::move(fn));
+        }
+        not_empty_.notify_one();
+    }
+
+    ~NaivePool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        not_empty_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::deque<std::function<void()>> queue_;
+    bool stop_ = false;
+    std::vector<std::thread> threads_;
+};
+
+size_t PoolSize() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+constexpr int64_t kFanout = 1000;
+constexpr auto kFanoutWork = std::chrono::microseconds(1);
+
+constexpr int kFib = 24;
+constexpr int kFibCutoff = 14;
+
+constexpr size_t kSumSize = size_t{1} << 22;
+constexpr size_t kSumChunks = 64;
+
+uint64_t SerialFib(int n) {
+    return n < 2 ? n : SerialFib(n - 1) + SerialFib(n - 2);
+}
+
+// Continuation passing, so pools never block a worker waiting on a child: the
+// last child to finish combines the results and completes its parent.
+struct FibNode {
+    FibNode* parent = nullptr;
+    uint64_t* result = nullptr;
+    std::atomic<int> pending = 2;
+    uint64_t left = 0;
+    uint64_t right = 0;
+};
+
+template <typename Spawn>
+void SpawnFib(const Spawn& spawn, int n, FibNode* parent, uint64_t* result, Latch* done);
+
+void CompleteFib(FibNode* node, Latch* done) {
+    while (node && node->pending.fetch_sub(1) == 1) {
+        *node->result = node->left + node->right;
+        auto parent = node->parent;
+        delete node;
+        node = parent;
+    }
+    if (!node) {
+        done->Signal();
+    }
+}
+
+template <typename Spawn>
+void SpawnFib(const Spawn& spawn, int n, FibNode* parent, uint64_t* result, Latch* done) {
+    spawn([&spawn, n, parent, result, done] {
+        if (n <= kFibCutoff) {
+            *result = SerialFib(n);
+            CompleteFib(parent, done);
+            return;
+        }
+        auto node = new FibNode{parent, result};
+        SpawnFib(spawn, n - 1, node, &node->left, done);
+        SpawnFib(spawn, n - 2, node, &node->right, done);
+    });
+}
+
+template <typename Spawn>
+uint64_t PoolFib(const Spawn& spawn) {
+    Latch done(1);
+    uint64_t result = 0;
+    SpawnFib(spawn, kFib, nullptr, &result, &done);
+    done.Wait();
+    return result;
+}
+
+uint64_t AsyncFib(int n) {
+    if (n <= kFibCutoff) {
+        return SerialFib(n);
+    }
+    auto left = std::async(std::launch::async, AsyncFib, n - 1);
+    auto right = AsyncFib(n - 2);
+    return left.get() + right;
+}
+
+uint64_t ThreadFib(int n) {
+    if (n <= kFibCutoff) {
+        return SerialFib(n);
+    }
+    uint64_t left = 0;
+    std::thread thread([&left, n] { left = ThreadFib(n - 1); });
+    auto right = ThreadFib(n - 2);
+    thread.join();
+    return left + right;
+}
+
+const std::vector<uint64_t>& SumInput() {
+    static const std::vector<uint64_t> input = [] {
+        std::vector<uint64_t> values(kSumSize);
+        std::iota(values.begin(), values.end(), 0);
+        return values;
+    }();
+    return input;
+}
+
+uint64_t SumChunk(size_t chunk) {
+    const auto& input = SumInput();
+    auto begin = input.begin() + chunk * (kSumSize / kSumChunks);
+    return std::accumulate(begin, begin + kSumSize / kSumChunks, uint64_t{0});
+}
+
+}  // namespace
+
+static void BenchmarkBaselineFanoutExecutor(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(PoolSize());
+    for (auto _ : state) {
+        Latch latch(kFanout);
+        for (int64_t i = 0; i < kFanout; ++i) {
+            executor->Submit(std::make_shared<FunctionTask>([&latch] {
+                SpinFor(kFanoutWork);
+                latch.Signal();
+            }));
+        }
+        latch.Wait();
+    }
+    ReportTasks(state, kFanout);
+}
+
+static void BenchmarkBaselineFanoutAsync(benchmark::State& state) {
+    for (auto _ : state) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(kFanout);
+        for (int64_t i = 0; i < kFanout; ++i) {
+            futures.push_back(std::async(std::launch::async, [] { SpinFor(kFanoutWork); }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+    ReportTasks(state, kFanout);
+}
+
+static void BenchmarkBaselineFanoutThreads(benchmark::State& state) {
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        threads.reserve(kFanout);
+        for (int64_t i = 0; i < kFanout; ++i) {
+            threads.emplace_back([] { SpinFor(kFanoutWork); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    ReportTasks(state, kFanout);
+}
+
+static void BenchmarkBaselineFanoutNaivePool(benchmark::State& state) {
+    NaivePool pool(PoolSize());
+    for (auto _ : state) {
+        Latch latch(kFanout);
+        for (int64_t i = 0; i < kFanout; ++i) {
+            pool.Submit([&latch] {
+                SpinFor(kFanoutWork);
+                latch.Signal();
+            });
+        }
+        latch.Wait();
+    }
+    ReportTasks(state, kFanout);
+}
+
+static void BenchmarkBaselineFibExecutor(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(PoolSize());
+    auto spawn = [&executor](std::function<void()> fn) {
+        executor->Submit(std::make_shared<FunctionTask>(std::move(fn)));
+    };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PoolFib(spawn));
+    }
+}
+
+static void BenchmarkBaselineFibAsync(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(AsyncFib(kFib));
+    }
+}
+
+static void BenchmarkBaselineFibThreads(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ThreadFib(kFib));
+    }
+}
+
+static void BenchmarkBaselineFibNaivePool(benchmark::State& state) {
+    NaivePool pool(PoolSize());
+    auto spawn = [&pool](std::function<void()> fn) { pool.Submit(std::move(fn)); };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PoolFib(spawn));
+    }
+}
+
+static void BenchmarkBaselineSumExecutor(benchmark::State& state) {
+    SumInput();
+    auto executor = MakeThreadPoolExecutor(PoolSize());
+    for (auto _ : state) {
+        std::vector<FuturePtr<uint64_t>> chunks;
+        for (size_t i = 0; i < kSumChunks; ++i) {
+            chunks.push_back(executor->Invoke<uint64_t>([i] { return SumChunk(i); }));
+        }
+        auto sums = executor->WhenAll(std::move(chunks))->Get();
+        benchmark::DoNotOptimize(std::accumulate(sums.begin(), sums.end(), uint64_t{0}));
+    }
+}
+
+static void BenchmarkBaselineSumAsync(benchmark::State& state) {
+    SumInput();
+    for (auto _ : state) {
+        std::vector<std::future<uint64_t>> chunks;
+        for (size_t i = 0; i < kSumChunks; ++i) {
+            chunks.push_back(std::async(std::launch::async, SumChunk, i));
+        }
+        uint64_t sum = 0;
+        for (auto& chunk : chunks) {
+            sum += chunk.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void BenchmarkBaselineSumThreads(benchmark::State& state) {
+    SumInput();
+    for (auto _ : state) {
+        std::vector<uint64_t> sums(kSumChunks);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < kSumChunks; ++i) {
+            threads.emplace_back([&sums, i] { sums[i] = SumChunk(i); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(std::accumulate(sums.begin(), sums.end(), uint64_t{0}));
+    }
+}
+
+static void BenchmarkBaselineSumNaivePool(benchmark::State& state) {
+    SumInput();
+    NaivePool pool(PoolSize());
+    for (auto _ : state) {
+        std::vector<uint64_t> sums(kSumChunks);
+        Latch latch(kSumChunks);
+        for (size_t i = 0; i < kSumChunks; ++i) {
+            pool.Submit([&sums, &latch, i] {
+                sums[i] = SumChunk(i);
+                latch.Signal();
+            });
+        }
+        latch.Wait();
+        benchmark::DoNotOptimize(std::accumulate(sums.begin(), sums.end(), uint64_t{0}));
+    }
+}
+
+BENCHMARK(BenchmarkBaselineFanoutExecutor)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFanoutAsync)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFanoutThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFanoutNaivePool)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BenchmarkBaselineFibExecutor)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFibAsync)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFibThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineFibNaivePool)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BenchmarkBaselineSumExecutor)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineSumAsync)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineSumThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BenchmarkBaselineSumNaivePool)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "executors/executors.h"
+
+class EmptyTask : public Task {
+public:
+    virtual void Run() override {
+    }
+};
+
+class Latch {
+public:
+    Latch(size_t count) : counter_(count) {
+    }
+
+    void Wait() {
+        std::unique_lock<std::mutex> guard(lock_);
+        done_.wait(guard, [this] { return counter_ == 0; });
+    }
+
+    void Signal() {
+        std::unique_lock<std::mutex> guard(lock_);
+        counter_--;
+        if (counter_ == 0) {
+            done_.notify_all();
+        }
+    }
+
+private:
+    std::mutex lock_;
+    std::condition_variable done_;
+    size_t counter_;
+};
+
+class LatchSignaler : public Task {
+public:
+    LatchSignaler(Latch* latch) : latch_(latch) {
+    }
+
+    virtual void Run() override {
+        latch_->Signal();
+    }
+
+private:
+    Latch* latch_;
+};
+
+inline void SpinFor(std::chrono::nanoseconds duration) {
+    auto until = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+// 1, 2, 4, ... up to std::thread::hardware_concurrency, which is always included
+inline std::vector<int64_t> WorkerCounts() {
+    int64_t max_workers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int64_t> counts;
+    for (int64_t count = 1; count < max_workers; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(max_workers);
+    return counts;
+}
+
+inline void ReportTasks(benchmark::State& state, int64_t tasks_per_iteration) {
+    state.counters["tasks"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tasks_per_iteration), benchmark::Counter::kIsRate);
+}
+
+// Wall time per element, for benchmarks whose iteration processes a batch
+inline void ReportPerElement(benchmark::State& state, int64_t elements_per_iteration) {
+    state.counters["per_element"] =
+        benchmark::Counter(static_cast<double>(state.iterations() * elements_per_iteration),
+                           benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
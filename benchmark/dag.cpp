@@ -0,0 +1,157 @@
+#include "common.h"
+
+#include "executors/simulated.h"
+
+#include <random>
+
+#include <malloc.h>
+#include <sys/resource.h>
+
+namespace {
+
+// Heap in use, unlike RSS it drops when a previous graph is freed
+size_t HeapInUseBytes() {
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+size_t PeakRssBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+double Milliseconds(std::chrono::steady_clock::duration value) {
+    return std::chrono::duration<double, std::milli>(value).count();
+}
+
+// Layers of kLayerWidth tasks, each depending on two random tasks of the previous layer
+std::vector<TaskSharedPtr> BuildLayeredDag(int64_t tasks) {
+    constexpr int64_t kLayerWidth = 1000;
+    std::mt19937_64 random(42);
+    std::vector<TaskSharedPtr> all;
+    all.reserve(tasks);
+    for (int64_t i = 0; i < tasks; ++i) {
+        auto task = std::make_shared<EmptyTask>();
+        int64_t layer_start = i / kLayerWidth * kLayerWidth;
+        if (layer_start > 0) {
+            for (int edge = 0; edge < 2; ++edge) {
+                task->AddDependency(all[layer_start - kLayerWidth + random() % kLayerWidth]);
+            }
+        }
+        all.push_back(std::move(task));
+    }
+    return all;
+}
+
+// Leaves first, every join depends on its two children; the last task is the root
+std::vector<TaskSharedPtr> BuildForkJoinDag(int64_t tasks) {
+    std::vector<TaskSharedPtr> all;
+    all.reserve(tasks);
+    int64_t leaves = (tasks + 1) / 2;
+    for (int64_t i = 0; i < leaves; ++i) {
+        all.push_back(std::make_shared<EmptyTask>());
+    }
+    for (int64_t level_start = 0, level_size = leaves; level_size > 1;) {
+        for (int64_t i = 0; i + 1 < level_size; i += 2) {
+            auto join = std::make_shared<EmptyTask>();
+            join->AddDependency(all[level_start + i]);
+            join->AddDependency(all[level_start + i + 1]);
+            all.push_back(std::move(join));
+        }
+        if (level_size % 2 == 1) {
+            auto carry = std::make_shared<EmptyTask>();
+            carry->AddDependency(all[level_start + level_size - 1]);
+            all.push_back(std::move(carry));
+        }
+        level_start += level_size;
+        level_size = (level_size + 1) / 2;
+    }
+    return all;
+}
+
+}  // namespace
+
+// Args: {workers, tasks}. Reports build and run time separately, the heap the
+// built graph takes per task, and the process peak RSS.
+template <std::vector<TaskSharedPtr> (*Build)(int64_t)>
+static void BenchmarkLargeDag(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    double build_ms = 0;
+    double run_ms = 0;
+    double bytes_per_task = 0;
+    int64_t tasks = 0;
+
+    for (auto _ : state) {
+        // Only submitting and running the graph counts towards the tasks rate
+        state.PauseTiming();
+        auto heap_before = HeapInUseBytes();
+        auto build_start = std::chrono::steady_clock::now();
+        auto graph = Build(state.range(1));
+        auto build_end = std::chrono::steady_clock::now();
+        bytes_per_task = static_cast<double>(HeapInUseBytes() - heap_before) / graph.size();
+        tasks = graph.size();
+        state.ResumeTiming();
+
+        auto run_start = std::chrono::steady_clock::now();
+        for (const auto& task : graph) {
+            executor->Submit(task);
+        }
+        for (const auto& task : graph) {
+            task->Wait();
+        }
+        auto run_end = std::chrono::steady_clock::now();
+
+        build_ms += Milliseconds(build_end - build_start);
+        run_ms += Milliseconds(run_end - run_start);
+
+        state.PauseTiming();
+        graph.clear();
+        state.ResumeTiming();
+    }
+
+    ReportTasks(state, tasks);
+    state.counters["build_ms"] = build_ms / state.iterations();
+    state.counters["run_ms"] = run_ms / state.iterations();
+    state.counters["bytes_per_task"] = bytes_per_task;
+    state.counters["peak_rss_mb"] = PeakRssBytes() / double(1 << 20);
+}
+
+BENCHMARK_TEMPLATE(BenchmarkLargeDag, BuildLayeredDag)
+    ->ArgsProduct({WorkerCounts(), {100000, 1000000, 10000000}})
+    ->ArgNames({"workers", "tasks"})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BenchmarkLargeDag, BuildForkJoinDag)
+    ->ArgsProduct({WorkerCounts(), {100000, 1000000, 10000000}})
+    ->ArgNames({"workers", "tasks"})
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Same graphs on the single-threaded simulator, as a bound on scheduling overhead
+static void BenchmarkSimulatedLargeDag(benchmark::State& state) {
+    int64_t tasks = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto graph = BuildLayeredDag(state.range(0));
+        tasks = graph.size();
+        state.ResumeTiming();
+
+        SimulatedExecutor executor(42);
+        for (const auto& task : graph) {
+            executor.Submit(task);
+        }
+        executor.RunUntilIdle();
+    }
+    ReportTasks(state, tasks);
+}
+
+BENCHMARK(BenchmarkSimulatedLargeDag)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->ArgName("tasks")
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
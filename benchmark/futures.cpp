@@ -0,0 +1,117 @@
+#include "common.h"
+
+// Latency from Invoke to the result being available in the caller
+static void BenchmarkInvoke(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    for (auto _ : state) {
+        auto future = executor->Invoke<int>([] { return 42; });
+        benchmark::DoNotOptimize(future->Get());
+    }
+}
+
+BENCHMARK(BenchmarkInvoke)->Apply([](benchmark::internal::Benchmark* b) {
+    for (auto workers : WorkerCounts()) {
+        b->Arg(workers);
+    }
+})->ArgName("workers")->UseRealTime();
+
+static void BenchmarkThen(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    for (auto _ : state) {
+        auto input = executor->Invoke<int>([] { return 42; });
+        auto future = executor->Then<int>(input, [input] { return input->Get() + 1; });
+        benchmark::DoNotOptimize(future->Get());
+    }
+}
+
+BENCHMARK(BenchmarkThen)->Apply([](benchmark::internal::Benchmark* b) {
+    for (auto workers : WorkerCounts()) {
+        b->Arg(workers);
+    }
+})->ArgName("workers")->UseRealTime();
+
+// Args: {workers, length}, Invoke followed by length Thens each reading its input
+static void BenchmarkThenChain(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto length = state.range(1);
+    for (auto _ : state) {
+        auto future = executor->Invoke<int64_t>([] { return int64_t{0}; });
+        for (int64_t i = 0; i < length; ++i) {
+            future = executor->Then<int64_t>(future, [future] { return future->Get() + 1; });
+        }
+        benchmark::DoNotOptimize(future->Get());
+    }
+    ReportPerElement(state, length + 1);
+}
+
+BENCHMARK(BenchmarkThenChain)
+    ->ArgsProduct({WorkerCounts(), {10, 100, 1000}})
+    ->ArgNames({"workers", "length"})
+    ->UseRealTime();
+
+// Args: {workers, width}, width Invokes joined by one combinator
+static void BenchmarkWhenAll(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto width = state.range(1);
+    for (auto _ : state) {
+        std::vector<FuturePtr<int64_t>> all;
+        all.reserve(width);
+        for (int64_t i = 0; i < width; ++i) {
+            all.push_back(executor->Invoke<int64_t>([i] { return i; }));
+        }
+        benchmark::DoNotOptimize(executor->WhenAll(std::move(all))->Get());
+    }
+    ReportPerElement(state, width);
+}
+
+BENCHMARK(BenchmarkWhenAll)
+    ->ArgsProduct({WorkerCounts(), {1, 10, 100, 1000}})
+    ->ArgNames({"workers", "width"})
+    ->UseRealTime();
+
+static void BenchmarkWhenFirst(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto width = state.range(1);
+    for (auto _ : state) {
+        std::vector<FuturePtr<int64_t>> all;
+        all.reserve(width);
+        for (int64_t i = 0; i < width; ++i) {
+            all.push_back(executor->Invoke<int64_t>([i] { return i; }));
+        }
+        benchmark::DoNotOptimize(executor->WhenFirst(all)->Get());
+        // Inputs still running would otherwise pile up across iterations
+        for (const auto& future : all) {
+            future->Wait();
+        }
+    }
+    ReportPerElement(state, width);
+}
+
+BENCHMARK(BenchmarkWhenFirst)
+    ->ArgsProduct({WorkerCounts(), {1, 10, 100, 1000}})
+    ->ArgNames({"workers", "width"})
+    ->UseRealTime();
+
+// Deadline is already due, so this measures the combinator and not the timer
+static void BenchmarkWhenAllBeforeDeadline(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto width = state.range(1);
+    for (auto _ : state) {
+        std::vector<FuturePtr<int64_t>> all;
+        all.reserve(width);
+        for (int64_t i = 0; i < width; ++i) {
+            all.push_back(executor->Invoke<int64_t>([i] { return i; }));
+        }
+        auto deadline = Clock::now();
+        benchmark::DoNotOptimize(executor->WhenAllBeforeDeadline(all, deadline)->Get());
+        for (const auto& future : all) {
+            future->Wait();
+        }
+    }
+    ReportPerElement(state, width);
+}
+
+BENCHMARK(BenchmarkWhenAllBeforeDeadline)
+    ->ArgsProduct({WorkerCounts(), {1, 10, 100, 1000}})
+    ->ArgNames({"workers", "width"})
+    ->UseRealTime();
@@ -0,0 +1,187 @@
+// Open-loop load generator: producers submit at a fixed arrival rate regardless
+// of how fast the pool completes tasks, and latency is measured from the
+// intended send time, so queueing delay behind a slow submit is not hidden
+// (coordinated omission).
+//
+// Usage: loadgen [--workers=N] [--producers=N] [--service_us=N] [--duration_ms=N]
+//                [--arrival=poisson|constant] [--utilizations=0.5,0.7,0.9]
+
+#include "common.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+struct LoadOptions {
+    int workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int producers = 1;
+    std::chrono::nanoseconds service_time = std::chrono::microseconds(50);
+    std::chrono::nanoseconds duration = std::chrono::seconds(2);
+    bool poisson = true;
+    std::vector<double> utilizations = {0.1, 0.3, 0.5, 0.7, 0.8, 0.9, 0.95};
+};
+
+class TimedTask : public Task {
+public:
+    TimedTask(Latch* latch, StatsClock::time_point intended, std::chrono::nanoseconds service_time,
+              uint64_t* latency)
+        : latch_(latch), intended_(intended), service_time_(service_time), latency_(latency) {
+    }
+
+    void Run() override {
+        SpinFor(service_time_);
+        *latency_ = NanosecondsBetween(intended_, StatsClock::now());
+        latch_->Signal();
+    }
+
+private:
+    Latch* latch_;
+    StatsClock::time_point intended_;
+    std::chrono::nanoseconds service_time_;
+    uint64_t* latency_;
+};
+
+// Send schedule of one producer, fixed before the run starts
+std::vector<std::chrono::nanoseconds> MakeSchedule(const LoadOptions& options, double rate,
+                                                   uint32_t seed) {
+    std::mt19937_64 random(seed);
+    std::exponential_distribution<double> poisson_gap(rate);
+    std::vector<std::chrono::nanoseconds> schedule;
+    double at = 0;
+    double end = std::chrono::duration<double>(options.duration).count();
+    while (true) {
+        at += options.poisson ? poisson_gap(random) : 1.0 / rate;
+        if (at >= end) {
+            break;
+        }
+        schedule.emplace_back(static_cast<int64_t>(at * 1e9));
+    }
+    return schedule;
+}
+
+HistogramSnapshot RunAtUtilization(const LoadOptions& options, double utilization) {
+    double service_seconds = std::chrono::duration<double>(options.service_time).count();
+    double rate_per_producer = utilization * options.workers / service_seconds / options.producers;
+
+    std::vector<std::vector<std::chrono::nanoseconds>> schedules;
+    size_t total_tasks = 0;
+    for (int i = 0; i < options.producers; ++i) {
+        schedules.push_back(MakeSchedule(options, rate_per_producer, 42 + i));
+        total_tasks += schedules.back().size();
+    }
+    std::vector<std::vector<uint64_t>> latencies(options.producers);
+    for (int i = 0; i < options.producers; ++i) {
+        latencies[i].resize(schedules[i].size());
+    }
+
+    auto executor = MakeThreadPoolExecutor(options.workers);
+    Latch latch(total_tasks);
+    auto start = StatsClock::now() + std::chrono::milliseconds(10);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < options.producers; ++i) {
+        producers.emplace_back([&, i] {
+            for (size_t j = 0; j < schedules[i].size(); ++j) {
+                auto intended = start + schedules[i][j];
+                // A late producer submits immediately, its lateness is part of the latency
+                std::this_thread::sleep_until(intended);
+                executor->Submit(std::make_shared<TimedTask>(&latch, intended,
+                                                             options.service_time,
+                                                             &latencies[i][j]));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    latch.Wait();
+
+    LatencyHistogram histogram;
+    for (const auto& producer_latencies : latencies) {
+        for (auto latency : producer_latencies) {
+            histogram.Record(latency);
+        }
+    }
+    HistogramSnapshot snapshot;
+    snapshot.Merge(histogram);
+    return snapshot;
+}
+
+std::vector<double> ParseList(std::string_view value) {
+    std::vector<double> result;
+    std::stringstream stream{std::string(value)};
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        result.push_back(std::stod(item));
+    }
+    return result;
+}
+
+LoadOptions ParseOptions(int argc, char** argv) {
+    LoadOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto eq = arg.find('=');
+        auto key = arg.substr(0, eq);
+        auto value = eq == std::string_view::npos ? std::string_view{} : arg.substr(eq + 1);
+        if (key == "--workers") {
+            options.workers = std::stoi(std::string(value));
+        } else if (key == "--producers") {
+            options.producers = std::stoi(std::string(value));
+        } else if (key == "--service_us") {
+            options.service_time = std::chrono::microseconds(std::stoll(std::string(value)));
+        } else if (key == "--duration_ms") {
+            options.duration = std::chrono::milliseconds(std::stoll(std::string(value)));
+        } else if (key == "--arrival") {
+            options.poisson = value != "constant";
+        } else if (key == "--utilizations") {
+            options.utilizations = ParseList(value);
+        } else {
+            std::cerr << "Unknown argument " << arg << "\n";
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    // The arrival rate divides by these, a non-positive value would never end a schedule
+    auto require_positive = [](bool positive, const char* name) {
+        if (!positive) {
+            std::cerr << "Argument " << name << " must be positive\n";
+            std::exit(EXIT_FAILURE);
+        }
+    };
+    require_positive(options.workers > 0, "--workers");
+    require_positive(options.producers > 0, "--producers");
+    require_positive(options.service_time.count() > 0, "--service_us");
+    for (auto utilization : options.utilizations) {
+        require_positive(utilization > 0, "--utilizations");
+    }
+    return options;
+}
+
+double Micros(std::chrono::nanoseconds value) {
+    return std::chrono::duration<double, std::micro>(value).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    auto options = ParseOptions(argc, argv);
+    std::printf("workers=%d producers=%d service=%.1fus arrival=%s\n", options.workers,
+                options.producers, Micros(options.service_time),
+                options.poisson ? "poisson" : "constant");
+    std::printf("%8s %12s %10s %10s %10s %10s %10s\n", "util", "rate/s", "tasks", "p50_us",
+                "p99_us", "p999_us", "max_us");
+    for (auto utilization : options.utilizations) {
+        auto latency = RunAtUtilization(options, utilization);
+        double rate = utilization * options.workers /
+                      std::chrono::duration<double>(options.service_time).count();
+        std::printf("%8.2f %12.0f %10lu %10.1f %10.1f %10.1f %10.1f\n", utilization, rate,
+                    static_cast<unsigned long>(latency.Count()), Micros(latency.P50()),
+                    Micros(latency.P99()), Micros(latency.P999()), Micros(latency.Max()));
+    }
+    return 0;
+}
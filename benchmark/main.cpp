@@ -1,12 +1,4 @@
-#include <benchmark/benchmark.h>
-
-#include "executors/executors.h"
-
-class EmptyTask : public Task {
-public:
-    virtual void Run() override {
-    }
-};
+#include "common.h"
 
 static void BenchmarkSimpleSubmit(benchmark::State& state) {
     auto executor = MakeThreadPoolExecutor(state.range(0));
@@ -51,49 +43,12 @@ BENCHMARK(BenchmarkFanoutFanin)
     ->Args({10, 10})
     ->Args({10, 100});
 
-class Latch {
-public:
-    Latch(size_t count) : counter_(count) {
-    }
-
-    void Wait() {
-        std::unique_lock<std::mutex> guard(lock_);
-        done_.wait(guard, [this] { return counter_ == 0; });
-    }
-
-    void Signal() {
-        std::unique_lock<std::mutex> guard(lock_);
-        counter_--;
-        if (counter_ == 0) {
-            done_.notify_all();
-        }
-    }
-
-private:
-    std::mutex lock_;
-    std::condition_variable done_;
-    size_t counter_;
-};
-
-class LatchSignaler : public Task {
-public:
-    LatchSignaler(Latch* latch) : latch_(latch) {
-    }
-
-    virtual void Run() override {
-        latch_->Signal();
-    }
-
-private:
-    Latch* latch_;
-};
-
 static void BenchmarkScalableTimers(benchmark::State& state) {
     auto executor = MakeThreadPoolExecutor(state.range(0));
 
     for (auto _ : state) {
         Latch latch(state.range(1));
-        auto at = std::chrono::system_clock::now() + std::chrono::milliseconds(5);
+        auto at = Clock::now() + std::chrono::milliseconds(5);
 
         for (size_t i = 0; i < static_cast<size_t>(state.range(1)); i++) {
             auto task = std::make_shared<LatchSignaler>(&latch);
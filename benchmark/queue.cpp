@@ -0,0 +1,84 @@
+#include "common.h"
+
+#include <limits>
+
+#include "executors/ubqueue.h"
+
+// Templated on the queue so alternative implementations can be compared on the
+// same workloads by adding a BENCHMARK_TEMPLATE registration.
+//
+// Args: {producers, consumers, burst}. burst == 0 pushes steadily; otherwise
+// producers push burst items and then pause for 20us, so consumers
+// repeatedly drain the queue and block.
+template <typename Q>
+static void BenchmarkQueuePushPop(benchmark::State& state) {
+    constexpr int64_t kItems = 100000;
+    constexpr uint64_t kStop = std::numeric_limits<uint64_t>::max();
+    auto producers = state.range(0);
+    auto consumers = state.range(1);
+    auto burst = state.range(2);
+
+    for (auto _ : state) {
+        Q queue;
+        std::vector<std::thread> threads;
+        for (int64_t i = 0; i < consumers; ++i) {
+            threads.emplace_back([&queue] {
+                while (auto value = queue.Pop()) {
+                    if (*value == kStop) {
+                        break;
+                    }
+                    benchmark::DoNotOptimize(*value);
+                }
+            });
+        }
+        std::vector<std::thread> producer_threads;
+        for (int64_t i = 0; i < producers; ++i) {
+            producer_threads.emplace_back([&queue, producers, burst] {
+                for (int64_t j = 0; j < kItems / producers; ++j) {
+                    queue.Push(static_cast<uint64_t>(j));
+                    if (burst > 0 && (j + 1) % burst == 0) {
+                        SpinFor(std::chrono::microseconds(20));
+                    }
+                }
+            });
+        }
+        for (auto& thread : producer_threads) {
+            thread.join();
+        }
+        for (int64_t i = 0; i < consumers; ++i) {
+            queue.Push(kStop);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * (kItems / producers) * producers);
+}
+
+static void QueueMixes(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"producers", "consumers", "burst"});
+    for (int64_t burst : {0, 256}) {
+        b->Args({1, 1, burst});
+        b->Args({4, 1, burst});
+        b->Args({1, 4, burst});
+        b->Args({4, 4, burst});
+        b->Args({8, 2, burst});
+    }
+}
+
+BENCHMARK_TEMPLATE(BenchmarkQueuePushPop, Queue<uint64_t>)
+    ->Apply(QueueMixes)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Uncontended cost of one Push and one TryPop
+template <typename Q>
+static void BenchmarkQueueSingleThread(benchmark::State& state) {
+    Q queue;
+    for (auto _ : state) {
+        queue.Push(1);
+        benchmark::DoNotOptimize(queue.TryPop());
+    }
+}
+
+BENCHMARK_TEMPLATE(BenchmarkQueueSingleThread, Queue<uint64_t>);
@@ -0,0 +1,142 @@
+// Replays a task graph recorded with ExecutorOptions::record_graph and
+// Executor::DumpGraph, with spin bodies of the recorded run times. The graph is
+// read from $EXECUTORS_REPLAY_GRAPH; without it a synthetic layered workload is
+// recorded in-process, so the benchmark always has something to run.
+
+#include "common.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+namespace {
+
+class ReplayTask : public Task {
+public:
+    explicit ReplayTask(std::chrono::nanoseconds run_time) : run_time_(run_time) {
+    }
+
+    void Run() override {
+        SpinFor(run_time_);
+    }
+
+private:
+    std::chrono::nanoseconds run_time_;
+};
+
+RecordedGraph RecordSyntheticGraph() {
+    constexpr int kLayers = 10;
+    constexpr int kWidth = 100;
+    auto executor = MakeThreadPoolExecutor(2, ExecutorOptions{.record_graph = true});
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> run_us(1, 50);
+    std::vector<TaskSharedPtr> previous;
+    std::vector<TaskSharedPtr> all;
+    for (int layer = 0; layer < kLayers; ++layer) {
+        std::vector<TaskSharedPtr> current;
+        for (int i = 0; i < kWidth; ++i) {
+            auto task = std::make_shared<ReplayTask>(std::chrono::microseconds(run_us(random)));
+            for (int edge = 0; edge < 2 && !previous.empty(); ++edge) {
+                task->AddDependency(previous[random() % previous.size()]);
+            }
+            current.push_back(task);
+        }
+        for (const auto& task : current) {
+            executor->Submit(task);
+            all.push_back(task);
+        }
+        previous = std::move(current);
+    }
+    for (const auto& task : all) {
+        task->Wait();
+    }
+    std::stringstream buffer;
+    executor->DumpGraph(buffer);
+    return ReadGraph(buffer);
+}
+
+const RecordedGraph& Graph() {
+    static const RecordedGraph graph = [] {
+        if (auto path = std::getenv("EXECUTORS_REPLAY_GRAPH")) {
+            std::ifstream in(path, std::ios::binary);
+            return ReadGraph(in);
+        }
+        return RecordSyntheticGraph();
+    }();
+    return graph;
+}
+
+}  // namespace
+
+// Args: {workers, paced}; paced submits every task at its recorded offset,
+// otherwise all tasks are submitted at once. Tasks that never ran in the
+// recording are left out, along with edges to them.
+static void BenchmarkReplay(benchmark::State& state) {
+    const auto& graph = Graph();
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    bool paced = state.range(1) != 0;
+    std::chrono::nanoseconds total_work{0};
+    int64_t replayed = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<TaskSharedPtr> tasks(graph.size());
+        for (size_t i = 0; i < graph.size(); ++i) {
+            if (graph[i].executed) {
+                tasks[i] = std::make_shared<ReplayTask>(graph[i].run_time);
+            }
+        }
+        for (size_t i = 0; i < graph.size(); ++i) {
+            if (!tasks[i]) {
+                continue;
+            }
+            for (auto dependency : graph[i].dependencies) {
+                if (tasks[dependency]) {
+                    tasks[i]->AddDependency(tasks[dependency]);
+                }
+            }
+            for (auto trigger : graph[i].triggers) {
+                if (tasks[trigger]) {
+                    tasks[i]->AddTrigger(tasks[trigger]);
+                }
+            }
+        }
+        state.ResumeTiming();
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < graph.size(); ++i) {
+            if (!tasks[i]) {
+                continue;
+            }
+            auto submit_at = paced ? start + graph[i].submitted_at : start;
+            if (graph[i].time_trigger) {
+                tasks[i]->SetTimeTrigger(submit_at + *graph[i].time_trigger);
+            }
+            if (paced) {
+                std::this_thread::sleep_until(submit_at);
+            }
+            executor->Submit(tasks[i]);
+        }
+        for (const auto& task : tasks) {
+            if (task) {
+                task->Wait();
+            }
+        }
+    }
+
+    for (const auto& task : graph) {
+        if (task.executed) {
+            total_work += task.run_time;
+            ++replayed;
+        }
+    }
+    ReportTasks(state, replayed);
+    state.counters["work_ms"] = std::chrono::duration<double, std::milli>(total_work).count();
+}
+
+BENCHMARK(BenchmarkReplay)
+    ->ArgsProduct({WorkerCounts(), {0, 1}})
+    ->ArgNames({"workers", "paced"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,225 @@
+#include "common.h"
+
+#include <random>
+
+// Args: {workers, producers}, every producer submits kTasksPerProducer tasks
+static void BenchmarkMultiProducerSubmit(benchmark::State& state) {
+    constexpr int64_t kTasksPerProducer = 10000;
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto producers = state.range(1);
+
+    for (auto _ : state) {
+        Latch latch(producers * kTasksPerProducer);
+        std::vector<std::thread> threads;
+        for (int64_t i = 0; i < producers; ++i) {
+            threads.emplace_back([&] {
+                for (int64_t j = 0; j < kTasksPerProducer; ++j) {
+                    executor->Submit(std::make_shared<LatchSignaler>(&latch));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        latch.Wait();
+    }
+    ReportTasks(state, producers * kTasksPerProducer);
+}
+
+BENCHMARK(BenchmarkMultiProducerSubmit)
+    ->ArgsProduct({WorkerCounts(), {1, 2, 4, 8}})
+    ->ArgNames({"workers", "producers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+class SpawningTask : public Task {
+public:
+    SpawningTask(Executor* executor, Latch* latch, int64_t children)
+        : executor_(executor), latch_(latch), children_(children) {
+    }
+
+    void Run() override {
+        for (int64_t i = 0; i < children_; ++i) {
+            executor_->Submit(std::make_shared<LatchSignaler>(latch_));
+        }
+    }
+
+private:
+    Executor* executor_;
+    Latch* latch_;
+    int64_t children_;
+};
+
+// Args: {workers, spawners}, tasks are submitted from inside worker threads
+static void BenchmarkSpawnFromWorker(benchmark::State& state) {
+    constexpr int64_t kChildren = 10000;
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto spawners = state.range(1);
+
+    for (auto _ : state) {
+        Latch latch(spawners * kChildren);
+        for (int64_t i = 0; i < spawners; ++i) {
+            executor->Submit(std::make_shared<SpawningTask>(executor.get(), &latch, kChildren));
+        }
+        latch.Wait();
+    }
+    ReportTasks(state, spawners * kChildren);
+}
+
+BENCHMARK(BenchmarkSpawnFromWorker)
+    ->ArgsProduct({WorkerCounts(), {1, 4}})
+    ->ArgNames({"workers", "spawners"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {workers, length, reversed}; reversed submits dependents before their dependencies
+static void BenchmarkDeepChain(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto length = state.range(1);
+    bool reversed = state.range(2) != 0;
+
+    for (auto _ : state) {
+        std::vector<TaskSharedPtr> chain;
+        chain.reserve(length);
+        for (int64_t i = 0; i < length; ++i) {
+            chain.push_back(std::make_shared<EmptyTask>());
+            if (i > 0) {
+                chain[i]->AddDependency(chain[i - 1]);
+            }
+        }
+        if (reversed) {
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+                executor->Submit(*it);
+            }
+        } else {
+            for (const auto& task : chain) {
+                executor->Submit(task);
+            }
+        }
+        chain.back()->Wait();
+    }
+    ReportTasks(state, length);
+}
+
+BENCHMARK(BenchmarkDeepChain)
+    ->ArgsProduct({WorkerCounts(), {100, 1000}, {0, 1}})
+    ->ArgNames({"workers", "length", "reversed"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static TaskSharedPtr BuildForkJoinTree(int64_t depth, std::vector<TaskSharedPtr>* tasks) {
+    auto node = std::make_shared<EmptyTask>();
+    if (depth > 0) {
+        node->AddDependency(BuildForkJoinTree(depth - 1, tasks));
+        node->AddDependency(BuildForkJoinTree(depth - 1, tasks));
+    }
+    tasks->push_back(node);
+    return node;
+}
+
+// Args: {workers, depth}, a complete binary tree of joins over 2^depth leaves
+static void BenchmarkBinaryTreeForkJoin(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto depth = state.range(1);
+    int64_t tasks_per_tree = (int64_t{2} << depth) - 1;
+
+    for (auto _ : state) {
+        std::vector<TaskSharedPtr> tasks;
+        tasks.reserve(tasks_per_tree);
+        auto root = BuildForkJoinTree(depth, &tasks);
+        for (const auto& task : tasks) {
+            executor->Submit(task);
+        }
+        root->Wait();
+    }
+    ReportTasks(state, tasks_per_tree);
+}
+
+BENCHMARK(BenchmarkBinaryTreeForkJoin)
+    ->ArgsProduct({WorkerCounts(), {6, 10, 14}})
+    ->ArgNames({"workers", "depth"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {workers, width}, one task depends on all others
+static void BenchmarkWideFanIn(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto width = state.range(1);
+
+    for (auto _ : state) {
+        auto join = std::make_shared<EmptyTask>();
+        std::vector<TaskSharedPtr> inputs;
+        inputs.reserve(width);
+        for (int64_t i = 0; i < width; ++i) {
+            inputs.push_back(std::make_shared<EmptyTask>());
+            join->AddDependency(inputs.back());
+        }
+        executor->Submit(join);
+        for (const auto& task : inputs) {
+            executor->Submit(task);
+        }
+        join->Wait();
+    }
+    ReportTasks(state, width + 1);
+}
+
+BENCHMARK(BenchmarkWideFanIn)
+    ->ArgsProduct({WorkerCounts(), {1000, 10000}})
+    ->ArgNames({"workers", "width"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+class SpinningTask : public Task {
+public:
+    SpinningTask(Latch* latch, std::chrono::nanoseconds duration)
+        : latch_(latch), duration_(duration) {
+    }
+
+    void Run() override {
+        SpinFor(duration_);
+        latch_->Signal();
+    }
+
+private:
+    Latch* latch_;
+    std::chrono::nanoseconds duration_;
+};
+
+// Args: {workers}; 89% of tasks spin 1us, 10% spin 10us, 1% spin 1ms. Reports
+// efficiency = useful spin time / (wall time * workers).
+static void BenchmarkSkewedDurations(benchmark::State& state) {
+    constexpr int64_t kTasks = 5000;
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::vector<std::chrono::nanoseconds> durations;
+    std::chrono::nanoseconds total_work{0};
+    for (int64_t i = 0; i < kTasks; ++i) {
+        auto roll = percent(random);
+        std::chrono::nanoseconds duration = roll == 0  ? std::chrono::milliseconds(1)
+                                            : roll < 11 ? std::chrono::microseconds(10)
+                                                        : std::chrono::microseconds(1);
+        durations.push_back(duration);
+        total_work += duration;
+    }
+
+    for (auto _ : state) {
+        Latch latch(kTasks);
+        for (auto duration : durations) {
+            executor->Submit(std::make_shared<SpinningTask>(&latch, duration));
+        }
+        latch.Wait();
+    }
+    ReportTasks(state, kTasks);
+    state.counters["efficiency"] = benchmark::Counter(
+        std::chrono::duration<double>(total_work).count() * state.iterations() /
+            static_cast<double>(state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BenchmarkSkewedDurations)
+    ->ArgsProduct({WorkerCounts()})
+    ->ArgNames({"workers"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
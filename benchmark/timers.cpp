@@ -0,0 +1,178 @@
+#include "common.h"
+
+class LatenessTask : public Task {
+public:
+    LatenessTask(Latch* latch, TimePoint at, uint64_t* lateness,
+                 std::chrono::nanoseconds slack = {})
+        : latch_(latch), at_(at), lateness_(lateness) {
+        SetTimeTrigger(at, slack);
+    }
+
+    void Run() override {
+        auto late = Clock::now() - at_;
+        *lateness_ = std::max<int64_t>(
+            0, std::chrono::duration_cast<std::chrono::nanoseconds>(late).count());
+        latch_->Signal();
+    }
+
+private:
+    Latch* latch_;
+    TimePoint at_;
+    uint64_t* lateness_;
+};
+
+static void ReportLateness(benchmark::State& state, const LatencyHistogram& histogram) {
+    HistogramSnapshot snapshot;
+    snapshot.Merge(histogram);
+    auto micros = [](std::chrono::nanoseconds value) {
+        return std::chrono::duration<double, std::micro>(value).count();
+    };
+    state.counters["late_p50_us"] = micros(snapshot.P50());
+    state.counters["late_p99_us"] = micros(snapshot.P99());
+    state.counters["late_p999_us"] = micros(snapshot.P999());
+    state.counters["late_max_us"] = micros(snapshot.Max());
+}
+
+// Args: {workers, timers, spread_ms}; deadlines are spread uniformly over
+// spread_ms and lateness is the actual start minus the trigger time
+static void BenchmarkTimerLateness(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto timers = state.range(1);
+    std::chrono::milliseconds spread(state.range(2));
+
+    LatencyHistogram histogram;
+    std::vector<uint64_t> lateness(timers);
+    for (auto _ : state) {
+        Latch latch(timers);
+        auto start = Clock::now() + std::chrono::milliseconds(5);
+        for (int64_t i = 0; i < timers; ++i) {
+            auto at = start + spread * i / timers;
+            executor->Submit(std::make_shared<LatenessTask>(&latch, at, &lateness[i]));
+        }
+        latch.Wait();
+
+        state.PauseTiming();
+        for (auto value : lateness) {
+            histogram.Record(value);
+        }
+        state.ResumeTiming();
+    }
+
+    ReportLateness(state, histogram);
+}
+
+BENCHMARK(BenchmarkTimerLateness)
+    ->ArgsProduct({WorkerCounts(), {100, 10000, 100000}, {10}})
+    ->ArgsProduct({WorkerCounts(), {100, 10000}, {2000}})
+    ->ArgNames({"workers", "timers", "spread_ms"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {workers, timers, slack_us}; deadlines are spread over 100ms, wakeups is
+// the number of timer batches released per iteration
+static void BenchmarkCoalescedTimers(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto timers = state.range(1);
+    std::chrono::microseconds slack(state.range(2));
+    std::chrono::milliseconds spread(100);
+
+    std::vector<uint64_t> lateness(timers);
+    auto wakeups_before = executor->GetStats().total.timer_wakeups;
+    for (auto _ : state) {
+        Latch latch(timers);
+        auto start = Clock::now() + std::chrono::milliseconds(5);
+        for (int64_t i = 0; i < timers; ++i) {
+            auto at = start + spread * i / timers;
+            executor->Submit(std::make_shared<LatenessTask>(&latch, at, &lateness[i], slack));
+        }
+        latch.Wait();
+    }
+
+    auto wakeups = executor->GetStats().total.timer_wakeups - wakeups_before;
+    state.counters["wakeups"] = benchmark::Counter(wakeups, benchmark::Counter::kAvgIterations);
+    ReportTasks(state, timers);
+}
+
+BENCHMARK(BenchmarkCoalescedTimers)
+    ->ArgsProduct({WorkerCounts(), {1000, 10000}, {0, 100, 1000}})
+    ->ArgNames({"workers", "timers", "slack_us"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {workers, timers, precise}; same lateness as BenchmarkTimerLateness for a
+// few timers spread over 10ms, precise ones spin the last spin_margin, whose cost
+// per timer is reported as spin_us
+static void BenchmarkPreciseTimerLateness(benchmark::State& state) {
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto timers = state.range(1);
+    bool precise = state.range(2) != 0;
+    std::chrono::milliseconds spread(10);
+
+    LatencyHistogram histogram;
+    std::vector<uint64_t> lateness(timers);
+    for (auto _ : state) {
+        Latch latch(timers);
+        auto start = Clock::now() + std::chrono::milliseconds(5);
+        for (int64_t i = 0; i < timers; ++i) {
+            auto at = start + spread * i / timers;
+            auto task = std::make_shared<LatenessTask>(&latch, at, &lateness[i]);
+            if (precise) {
+                task->SetPreciseTimeTrigger(at);
+            }
+            executor->Submit(std::move(task));
+        }
+        latch.Wait();
+
+        state.PauseTiming();
+        for (auto value : lateness) {
+            histogram.Record(value);
+        }
+        state.ResumeTiming();
+    }
+
+    ReportLateness(state, histogram);
+    auto spin = executor->GetStats().total.spin_time;
+    state.counters["spin_us"] =
+        std::chrono::duration<double, std::micro>(spin).count() / (state.iterations() * timers);
+}
+
+BENCHMARK(BenchmarkPreciseTimerLateness)
+    ->ArgsProduct({WorkerCounts(), {1, 10, 100}, {0, 1}})
+    ->ArgNames({"workers", "timers", "precise"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {workers, tasks}; every task runs every millisecond on one reused task
+// object until it ticked kTicks times, ticks is the total rate
+static void BenchmarkPeriodicTasks(benchmark::State& state) {
+    constexpr int kTicks = 10;
+    auto executor = MakeThreadPoolExecutor(state.range(0));
+    auto tasks = state.range(1);
+
+    std::vector<std::shared_ptr<PeriodicTask>> periodic(tasks);
+    for (auto _ : state) {
+        Latch latch(tasks);
+        for (auto& task : periodic) {
+            task = executor->SchedulePeriodic(
+                [&latch, ticks = 0]() mutable {
+                    if (++ticks == kTicks) {
+                        latch.Signal();
+                    }
+                },
+                std::chrono::milliseconds(1));
+        }
+        latch.Wait();
+        for (auto& task : periodic) {
+            task->Cancel();
+        }
+    }
+
+    state.counters["ticks"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * tasks * kTicks), benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BenchmarkPeriodicTasks)
+    ->ArgsProduct({WorkerCounts(), {10, 1000, 10000}})
+    ->ArgNames({"workers", "tasks"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+
+// Time triggers are monotonic, so wall clock adjustments never fire or delay them
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
+// Source of the current time for time triggers, see ExecutorOptions::clock
+using ClockFunction = TimePoint (*)();
+
+// CLOCK_MONOTONIC_COARSE: the last scheduler tick, read from the vDSO without a
+// syscall. Same epoch as Clock, but only tick resolution (usually 1-4ms).
+TimePoint CoarseClockNow() noexcept;
+
+// Maps a wall clock deadline onto Clock by its distance from the current wall time
+inline TimePoint FromSystemTime(std::chrono::system_clock::time_point at) noexcept {
+    return Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                              at - std::chrono::system_clock::now());
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#ifndef EXECUTORS_LATENCY_HISTOGRAMS
+#define EXECUTORS_LATENCY_HISTOGRAMS 1
+#endif
+
+inline constexpr bool kLatencyHistograms = EXECUTORS_LATENCY_HISTOGRAMS;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "executors/counters.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+struct alignas(kCacheLineSize) LockCounters {
+    // Only maintained where the lock holder can bump it cheaply
+    std::atomic<uint64_t> acquisitions = 0;
+    std::atomic<uint64_t> contended = 0;
+    std::atomic<uint64_t> wait_ns = 0;
+};
+
+// try_lock fast path, only acquisitions that have to wait are timed
+template <typename Mutex>
+std::unique_lock<Mutex> LockProfiled(Mutex& mutex, LockCounters& counters) {
+    std::unique_lock lock{mutex, std::try_to_lock};
+    if (!lock) {
+        auto start = std::chrono::steady_clock::now();
+        lock.lock();
+        auto waited = std::chrono::steady_clock::now() - start;
+        counters.contended.fetch_add(1, std::memory_order_relaxed);
+        counters.wait_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count(),
+            std::memory_order_relaxed);
+    }
+    return lock;
+}
+
+struct LockStats {
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0;
+    std::chrono::nanoseconds wait_time{0};
+
+    void Load(const LockCounters& counters) noexcept {
+        acquisitions = counters.acquisitions.load(std::memory_order_relaxed);
+        contended = counters.contended.load(std::memory_order_relaxed);
+        wait_time = std::chrono::nanoseconds(counters.wait_ns.load(std::memory_order_relaxed));
+    }
+};
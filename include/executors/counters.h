@@ -0,0 +1,12 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+inline constexpr size_t kCacheLineSize = 64;
+
+// Written only by the owning worker, read by anyone
+inline void Bump(std::atomic<uint64_t>& counter, uint64_t delta = 1) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
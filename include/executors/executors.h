@@ -1,18 +1,30 @@
 #pragma once
 
+#include "executors/clock.h"
+#include "executors/config.h"
+#include "executors/contention.h"
+#include "executors/exporter.h"
+#include "executors/probes.h"
+#include "executors/profile.h"
+#include "executors/recorder.h"
+#include "executors/stats.h"
+#include "executors/trace.h"
 #include "executors/ubqueue.h"
+#include "executors/watchdog.h"
 
 #include <condition_variable>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <ostream>
+#include <stop_token>
+#include <string>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
-using Clock = std::chrono::system_clock;
-using TimePoint = Clock::time_point;
-
 enum class TaskState { Pending, Running, Completed, Failed, Canceled };
 
 class Task;
@@ -25,11 +37,39 @@ public:
 
     virtual void Run() = 0;
 
+    uint64_t GetId() const noexcept {
+        return id_;
+    }
+
+    // Groups the task in profiles instead of its type. Profiles keep the raw pointer, so
+    // label must have static storage, e.g. a string literal
+    void SetLabel(const char* label) noexcept {
+        label_ = label;
+    }
+
+    const char* GetLabel() const noexcept {
+        return label_;
+    }
+
+    // Label if set, demangled dynamic type otherwise
+    std::string GetName() const;
+
     void AddDependency(TaskSharedPtr dep) noexcept;
 
     void AddTrigger(TaskSharedPtr dep) noexcept;
 
-    void SetTimeTrigger(TimePoint at) noexcept;
+    // The task may run anywhere in [at, at + slack], which lets the executor
+    // release timers with overlapping windows in one wake-up
+    void SetTimeTrigger(TimePoint at, std::chrono::nanoseconds slack = {}) noexcept;
+
+    void SetTimeTrigger(std::chrono::system_clock::time_point at,
+                        std::chrono::nanoseconds slack = {}) noexcept {
+        SetTimeTrigger(FromSystemTime(at), slack);
+    }
+
+    // Sleeps until ExecutorOptions::spin_margin before at, then spins on a worker
+    // and runs the task there, for deadlines finer than OS sleep resolution
+    void SetPreciseTimeTrigger(TimePoint at) noexcept;
 
     bool IsPending() const noexcept;
 
@@ -43,25 +83,76 @@ public:
 
     std::exception_ptr GetError() const noexcept;
 
-    void TryExecute();
+    // Returns true if this call ran the task body
+    bool TryExecute();
 
+    // A periodic task that is running is canceled before its next run
     void Cancel() noexcept;
 
+    // Returns once the task is finished, for a periodic task once it is canceled or failed
     void Wait() noexcept;
 
     virtual ~Task() = default;
 
 private:
+    friend class Executor;
+    friend class SimulatedExecutor;
+    friend class PeriodicTask;
+
+    enum class ExecuteResult {
+        Executed,
+        // Waits for dependencies or triggers
+        Blocked,
+        // Only waits for the time trigger
+        Timer,
+        NotPending
+    };
+
+    // Reads clock only if the task has a time trigger and now is not given
+    ExecuteResult Execute(ClockFunction clock, std::optional<TimePoint> now = std::nullopt);
+
+    static uint64_t NextId() noexcept;
+
+    // Requires mutex_
+    bool DependenciesSatisfied() const noexcept;
+
+    // Process-wide, split by the caller that contended for mutex_
+    static LockCounters execute_lock_counters_;
+    static LockCounters wait_lock_counters_;
+    static LockCounters other_lock_counters_;
+
+    // Bumped by every canceled periodic task, executors prune their timers when it changes
+    static std::atomic<uint64_t> periodic_cancels_;
+
+    // now is set only for tasks with a time trigger
+    StatsClock::time_point ReadyTime(std::optional<TimePoint> now) const noexcept;
+
+    const uint64_t id_ = NextId();
+    const char* label_ = nullptr;
+
     mutable std::mutex mutex_;
     std::condition_variable cv_;
 
     std::atomic<TaskState> state_ = TaskState::Pending;
 
+    // Periodic tasks go back to Pending after a successful run
+    bool periodic_ = false;
+    std::atomic<bool> cancel_requested_ = false;
+
     std::vector<TaskSharedPtr> dependencies_;
     std::vector<TaskSharedPtr> triggers_;
-    TimePoint time_trigger_ = Clock::now();
+    TimePoint time_trigger_ = TimePoint::min();
+    std::chrono::nanoseconds time_slack_{0};
+    bool precise_timer_ = false;
 
     std::exception_ptr exception_;
+
+    StatsClock::time_point submitted_at_;
+
+    // Latency timestamps, only maintained with EXECUTORS_LATENCY_HISTOGRAMS
+    StatsClock::time_point ready_at_;
+    StatsClock::time_point started_at_;
+    StatsClock::time_point finished_at_;
 };
 
 template <typename T>
@@ -94,64 +185,121 @@ private:
 template <typename T>
 using FuturePtr = std::shared_ptr<Future<T>>;
 
-// Used instead of void in generic code
-struct Unit {};
+enum class PeriodicMode {
+    // Runs at start + k * period, however long each run takes
+    FixedRate,
+    // Runs period after the previous run finished
+    FixedDelay
+};
+
+// What a FixedRate task does with ticks that passed while it was late
+enum class MissedTickPolicy {
+    // Waits for the next tick in the future
+    Skip,
+    // Runs once right away for all of them
+    Coalesce,
+    // Runs every missed tick back to back
+    CatchUp
+};
+
+struct PeriodicOptions {
+    PeriodicMode mode = PeriodicMode::FixedRate;
+    MissedTickPolicy missed_ticks = MissedTickPolicy::Skip;
+    // First run, one period after scheduling if unset
+    std::optional<TimePoint> start = std::nullopt;
+    // Passed to the time trigger of every run, see Task::SetTimeTrigger
+    std::chrono::nanoseconds slack{0};
+    bool precise = false;
+    // See Task::SetLabel
+    const char* label = nullptr;
+};
 
-class Executor {
+// One task object rearmed after every run, see Executor::SchedulePeriodic
+class PeriodicTask final : public Task {
 public:
-    Executor() = delete;
+    PeriodicTask(std::function<void()> fn, std::chrono::nanoseconds period,
+                 PeriodicOptions options);
 
-    Executor(size_t total_threads) {
-        thread_pool_.reserve(total_threads);
-        for (size_t i = 0; i < total_threads; ++i) {
-            thread_pool_.emplace_back([this]() -> void {
-                while (auto task = scheduler_.Pop()) {
-                    if (!(*task) || (*task)->IsCanceled()) {
-                        continue;
-                    }
-                    (*task)->TryExecute();
-                    if (!(*task)->IsFinished()) {
-                        scheduler_.Push(*task);
-                    }
-                }
-            });
-        }
+    void Run() final override {
+        fn_();
+        runs_.fetch_add(1, std::memory_order_relaxed);
     }
 
-    void Submit(TaskSharedPtr task) noexcept {
-        if (scheduler_.IsCanceled()) {
-            task->Cancel();
-            return;
-        }
-        if (task->IsPending()) {
-            scheduler_.Push(std::move(task));
-        }
+    uint64_t GetRuns() const noexcept {
+        return runs_.load(std::memory_order_relaxed);
     }
 
-    void StartShutdown() noexcept {
-        scheduler_.Cancel();
+    // Ticks dropped by MissedTickPolicy::Skip or Coalesce
+    uint64_t GetMissedTicks() const noexcept {
+        return missed_ticks_.load(std::memory_order_relaxed);
     }
 
-    void WaitShutdown() noexcept {
-        for (auto& cur_thread : thread_pool_) {
-            if (cur_thread.joinable()) {
-                cur_thread.join();
-            }
-        }
-    }
+private:
+    friend class Executor;
+    friend class SimulatedExecutor;
+
+    // Sets the time trigger of the first run
+    void Arm(TimePoint now) noexcept;
+
+    // Sets the time trigger of the run after the one that finished at now
+    void Rearm(TimePoint now) noexcept;
+
+    void SetTrigger(TimePoint at) noexcept;
+
+    std::function<void()> fn_;
+    const TimePoint::duration period_;
+    const PeriodicOptions options_;
+    // Schedule point of the last armed run, only touched by the running worker
+    TimePoint tick_;
+    std::atomic<uint64_t> runs_ = 0;
+    std::atomic<uint64_t> missed_ticks_ = 0;
+};
+
+// Used instead of void in generic code
+struct Unit {};
+
+enum class SnapshotState { Pending, Ready, Running };
+
+struct TaskSnapshot {
+    uint64_t task_id = 0;
+    // Task label or demangled type name
+    std::string name;
+    SnapshotState state = SnapshotState::Pending;
+    // Since the last Submit
+    std::chrono::nanoseconds age{0};
+    std::optional<TimePoint> time_trigger;
+    // Delay left until the time trigger by the executor clock, negative once it passed
+    std::optional<std::chrono::nanoseconds> time_trigger_in;
+    std::vector<uint64_t> unfinished_dependencies;
+    // Only set for Running, unset for a task that started while the snapshot was taken
+    std::optional<size_t> worker;
+    std::thread::id thread;
+    std::chrono::nanoseconds running_for{0};
+    // False for a task that was busy, only its state and age are known
+    bool complete = true;
+};
+
+std::ostream& operator<<(std::ostream& out, const TaskSnapshot& snapshot);
 
+// Future combinators for any executor providing Submit(TaskSharedPtr)
+template <typename Derived>
+class FutureCombinators {
+public:
     template <typename T>
-    FuturePtr<T> Invoke(std::function<T()> fn) noexcept {
+    FuturePtr<T> Invoke(std::function<T()> fn, const char* label = nullptr) noexcept {
         auto task_ptr = std::make_shared<Future<T>>(fn);
-        Submit(task_ptr);
+        task_ptr->SetLabel(label);
+        static_cast<Derived*>(this)->Submit(task_ptr);
         return task_ptr;
     }
 
     template <typename Y, typename T>
-    FuturePtr<Y> Then(FuturePtr<T> input, std::function<Y()> fn) noexcept {
+    FuturePtr<Y> Then(FuturePtr<T> input, std::function<Y()> fn,
+                      const char* label = nullptr) noexcept {
         auto task_ptr = std::make_shared<Future<Y>>(fn);
+        task_ptr->SetLabel(label);
         task_ptr->AddDependency(input);
-        Submit(task_ptr);
+        static_cast<Derived*>(this)->Submit(task_ptr);
         return task_ptr;
     }
 
@@ -165,10 +313,11 @@ public:
             }
             return result;
         });
+        task_ptr->SetLabel("WhenAll");
         for (const auto& dep : all) {
             task_ptr->AddDependency(dep);
         }
-        Submit(task_ptr);
+        static_cast<Derived*>(this)->Submit(task_ptr);
         return task_ptr;
     }
 
@@ -182,10 +331,11 @@ public:
             }
             return all.front()->Get();
         });
+        task_ptr->SetLabel("WhenFirst");
         for (const auto& dep : all) {
             task_ptr->AddTrigger(dep);
         }
-        Submit(task_ptr);
+        static_cast<Derived*>(this)->Submit(task_ptr);
         return task_ptr;
     }
 
@@ -202,19 +352,244 @@ public:
             }
             return result;
         });
+        task_ptr->SetLabel("WhenAllBeforeDeadline");
         task_ptr->SetTimeTrigger(deadline);
-        Submit(task_ptr);
+        static_cast<Derived*>(this)->Submit(task_ptr);
         return task_ptr;
     }
 
+    template <typename T>
+    FuturePtr<std::vector<T>> WhenAllBeforeDeadline(
+        std::vector<FuturePtr<T>> all, std::chrono::system_clock::time_point deadline) noexcept {
+        return WhenAllBeforeDeadline(std::move(all), FromSystemTime(deadline));
+    }
+};
+
+struct ExecutorOptions {
+    // Distinguishes pools in exported metrics
+    std::string name = "executor";
+
+    // Events kept per worker for DumpTrace, zero disables tracing
+    size_t trace_capacity = 0;
+
+    // Aggregate run time per task type or label for DumpProfile
+    bool profile_tasks = false;
+
+    // Measure CLOCK_THREAD_CPUTIME_ID around Run, costs two syscalls per task
+    bool measure_cpu_time = false;
+
+    // Record submitted tasks, their edges and run times for DumpGraph
+    bool record_graph = false;
+
+    // Time source for time triggers, e.g. CoarseClockNow or a test clock; must share Clock's epoch
+    ClockFunction clock = &Clock::now;
+
+    // How early a worker wakes for a precise time trigger and spins, which bounds
+    // the spin per wake-up; zero treats precise triggers as ordinary ones
+    std::chrono::nanoseconds spin_margin = std::chrono::microseconds(200);
+
+    WatchdogOptions watchdog = {};
+
+    // Prometheus exporter, enabled when a socket or file path is set
+    ExporterOptions exporter = {};
+};
+
+class Executor : public FutureCombinators<Executor> {
+public:
+    Executor() = delete;
+
+    Executor(size_t total_threads, ExecutorOptions options = {})
+        : worker_counters_(total_threads),
+          worker_histograms_(kLatencyHistograms ? total_threads : 0),
+          worker_profiles_(options.profile_tasks ? total_threads : 0),
+          worker_slots_(total_threads),
+          tracer_(total_threads, options.trace_capacity),
+          recorder_(options.record_graph),
+          measure_cpu_time_(options.measure_cpu_time),
+          clock_(options.clock),
+          spin_margin_(std::max(options.spin_margin, std::chrono::nanoseconds{0})),
+          watchdog_options_(std::move(options.watchdog)),
+          name_(std::move(options.name)) {
+        if (!options.exporter.socket_path.empty() || !options.exporter.file_path.empty()) {
+            exporter_ = std::make_unique<MetricsExporter>(
+                [this] { return FormatPrometheus(GetStats(), name_); },
+                std::move(options.exporter));
+        }
+        thread_pool_.reserve(total_threads);
+        for (size_t i = 0; i < total_threads; ++i) {
+            thread_pool_.emplace_back([this, i]() -> void { WorkerLoop(i); });
+        }
+        if (watchdog_options_.period.count() > 0) {
+            watchdog_ = std::jthread([this](std::stop_token stop) { WatchdogLoop(stop); });
+        }
+    }
+
+    void Submit(TaskSharedPtr task) noexcept {
+        if (scheduler_.IsCanceled()) {
+            submit_counters_.rejected.fetch_add(1, std::memory_order_relaxed);
+            if (tracer_.IsEnabled()) {
+                TraceSubmit(*task, TraceEventType::Cancel);
+            }
+            task->Cancel();
+            return;
+        }
+        if (task->IsPending()) {
+            submit_counters_.submitted.fetch_add(1, std::memory_order_relaxed);
+            task->submitted_at_ = StatsClock::now();
+            if (tracer_.IsEnabled()) {
+                TraceSubmit(*task, TraceEventType::Submit);
+            }
+            if (recorder_.IsEnabled()) {
+                RecordSubmit(*task);
+            }
+            EXECUTORS_PROBE3(submit, task.get(), task->GetId(), scheduler_.Size());
+            scheduler_.Push(std::move(task));
+        }
+    }
+
+    // Runs fn every period on one reused task until it is canceled or fn throws;
+    // throws std::invalid_argument unless period is positive
+    std::shared_ptr<PeriodicTask> SchedulePeriodic(std::function<void()> fn,
+                                                   std::chrono::nanoseconds period,
+                                                   PeriodicOptions options = {});
+
+    const std::string& GetName() const noexcept {
+        return name_;
+    }
+
+    ExecutorStats GetStats() const;
+
+    // Pending, ready and running tasks; workers keep running while it is taken
+    std::vector<TaskSnapshot> Snapshot() const;
+
+    // Per task type statistics, sorted by total run time
+    std::vector<TaskTypeProfile> GetProfile() {
+        return MergeProfiles(worker_profiles_);
+    }
+
+    void DumpProfile(std::ostream& out) {
+        WriteProfile(out, GetProfile());
+    }
+
+    // Writes the recorded events as Chrome Trace Event JSON
+    void DumpTrace(std::ostream& out) const {
+        tracer_.WriteChromeTrace(out);
+    }
+
+    // Writes the recorded task graph, see ReadGraph
+    void DumpGraph(std::ostream& out) const {
+        WriteGraph(out, recorder_.Collect());
+    }
+
+    // The recorded graph grows with every submit, long runs should clear it after each dump
+    void ClearGraph() {
+        recorder_.Clear();
+    }
+
+    // Tasks waiting for their time trigger, periodic ones included, are canceled
+    void StartShutdown() noexcept {
+        scheduler_.Cancel();
+        CancelTimers();
+        watchdog_.request_stop();
+    }
+
+    void WaitShutdown() noexcept {
+        for (auto& cur_thread : thread_pool_) {
+            if (cur_thread.joinable()) {
+                cur_thread.join();
+            }
+        }
+        if (watchdog_.joinable() && watchdog_.get_id() != std::this_thread::get_id()) {
+            watchdog_.join();
+        }
+    }
+
     ~Executor() {
         StartShutdown();
         WaitShutdown();
     }
 
 private:
+    struct alignas(kCacheLineSize) WorkerSlot {
+        mutable std::mutex mutex;
+        TaskSharedPtr task;
+        StatsClock::time_point since;
+    };
+
+    struct TimerEntry {
+        TimePoint at;
+        TaskSharedPtr task;
+        // Woken spin_margin_ early, the worker spins the rest and runs the task itself
+        bool precise = false;
+
+        // Orders the heap earliest first
+        bool operator<(const TimerEntry& other) const noexcept {
+            return at > other.at;
+        }
+    };
+
+    static constexpr TimePoint::rep kNoTimer = TimePoint::max().time_since_epoch().count();
+
+    void WorkerLoop(size_t index);
+
+    void RunTask(size_t index, TaskSharedPtr task);
+
+    // Parks a task until its time trigger instead of requeueing it
+    void AddTimer(TaskSharedPtr task);
+
+    void PushTimer(TimerEntry entry);
+
+    void ReleaseDueTimers(size_t index);
+
+    void CancelTimers() noexcept;
+
+    // Drops canceled periodic tasks from the heap, requires timers_mutex_
+    void PruneCanceledTimers();
+
+    // When an idle worker has to wake up for the earliest timer, nullopt without timers
+    std::optional<StatsClock::time_point> TimerWakeup() const noexcept;
+
+    void WatchdogLoop(std::stop_token stop);
+
+    void CheckStalls(std::unordered_set<uint64_t>* reported);
+
+    void RecordExecuted(size_t index, Task& task, StatsClock::time_point start,
+                        StatsClock::time_point end);
+
+    void RecordCanceled(size_t index, const Task& task, StatsClock::time_point at);
+
+    void TraceSubmit(const Task& task, TraceEventType type) noexcept;
+
+    void RecordSubmit(const Task& task);
+
+    void TraceExecuted(size_t index, Task& task, StatsClock::time_point start,
+                       StatsClock::time_point end) noexcept;
+
+    std::vector<WorkerCounters> worker_counters_;
+    std::vector<WorkerHistograms> worker_histograms_;
+    std::vector<WorkerProfile> worker_profiles_;
+    std::vector<WorkerSlot> worker_slots_;
+    SubmitCounters submit_counters_;
+    Tracer tracer_;
+    GraphRecorder recorder_;
+
+    const bool measure_cpu_time_;
+    const ClockFunction clock_;
+    const std::chrono::nanoseconds spin_margin_;
+    WatchdogOptions watchdog_options_;
+
+    std::string name_;
+
+    mutable std::mutex timers_mutex_;
+    std::vector<TimerEntry> timers_;
+    std::atomic<TimePoint::rep> next_timer_ = kNoTimer;
+    // Task::periodic_cancels_ at the last prune, written under timers_mutex_
+    std::atomic<uint64_t> pruned_cancels_ = 0;
+
     std::vector<std::jthread> thread_pool_;
     Queue<TaskSharedPtr> scheduler_;
+    std::jthread watchdog_;
+    std::unique_ptr<MetricsExporter> exporter_;
 };
 
-std::shared_ptr<Executor> MakeThreadPoolExecutor(int num_threads);
+std::shared_ptr<Executor> MakeThreadPoolExecutor(int num_threads, ExecutorOptions options = {});
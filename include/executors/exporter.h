@@ -0,0 +1,44 @@
+#pragma once
+
+#include "executors/stats.h"
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Prometheus text exposition format (version 0.0.4), every sample is labelled
+// with executor="<executor>"
+std::string FormatPrometheus(const ExecutorStats& stats, std::string_view executor);
+
+struct ExporterOptions {
+    // UNIX domain socket to serve metrics on, one response per connection
+    std::string socket_path;
+    // File atomically rewritten every interval
+    std::string file_path;
+    std::chrono::milliseconds interval{10000};
+};
+
+class MetricsExporter {
+public:
+    // Throws std::system_error if the socket cannot be bound
+    MetricsExporter(std::function<std::string()> render, ExporterOptions options);
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    ~MetricsExporter();
+
+private:
+    void Loop(std::stop_token stop);
+
+    void Serve(int client);
+
+    void WriteFile();
+
+    std::function<std::string()> render_;
+    ExporterOptions options_;
+    int listen_fd_ = -1;
+    std::jthread thread_;
+};
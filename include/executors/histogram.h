@@ -0,0 +1,95 @@
+#pragma once
+
+#include "executors/counters.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Log-bucketed histogram in the spirit of HdrHistogram: every power of two is
+// split into kSubBuckets linear buckets, so the relative error stays below
+// 1 / kSubBuckets over the whole range.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    static constexpr size_t kMaxBit = 47;
+    static constexpr size_t kBuckets = (kMaxBit - kSubBucketBits + 2) * kSubBuckets;
+
+    static size_t BucketOf(uint64_t value) noexcept;
+
+    static uint64_t LowerBound(size_t bucket) noexcept;
+
+    static uint64_t UpperBound(size_t bucket) noexcept;
+
+    // Single writer only: the owning worker
+    void Record(uint64_t value) noexcept;
+
+    uint64_t Count(size_t bucket) const noexcept {
+        return buckets_[bucket].load(std::memory_order_relaxed);
+    }
+
+    uint64_t Sum() const noexcept {
+        return sum_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Max() const noexcept {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> sum_ = 0;
+    std::atomic<uint64_t> max_ = 0;
+};
+
+class HistogramSnapshot {
+public:
+    HistogramSnapshot() : buckets_(LatencyHistogram::kBuckets) {
+    }
+
+    void Merge(const LatencyHistogram& histogram) noexcept;
+
+    void Merge(const HistogramSnapshot& other) noexcept;
+
+    uint64_t Count() const noexcept {
+        return count_;
+    }
+
+    const std::vector<uint64_t>& Buckets() const noexcept {
+        return buckets_;
+    }
+
+    std::chrono::nanoseconds Sum() const noexcept {
+        return std::chrono::nanoseconds(sum_);
+    }
+
+    std::chrono::nanoseconds Max() const noexcept {
+        return std::chrono::nanoseconds(max_);
+    }
+
+    std::chrono::nanoseconds Mean() const noexcept;
+
+    // percentile is in [0, 100]
+    std::chrono::nanoseconds Percentile(double percentile) const noexcept;
+
+    std::chrono::nanoseconds P50() const noexcept {
+        return Percentile(50.0);
+    }
+
+    std::chrono::nanoseconds P99() const noexcept {
+        return Percentile(99.0);
+    }
+
+    std::chrono::nanoseconds P999() const noexcept {
+        return Percentile(99.9);
+    }
+
+private:
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+};
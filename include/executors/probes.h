@@ -0,0 +1,40 @@
+#pragma once
+
+// USDT probes of the "executors" provider, compiled to nothing unless the
+// library is built with EXECUTORS_USDT and <sys/sdt.h> is available:
+//
+//   queue_push(queue, depth)        after an element is enqueued
+//   queue_pop(queue, depth)         after an element is dequeued
+//   submit(task, task_id, depth)    Executor::Submit queued a task
+//   pop(task, worker, depth)        a worker took a task from the queue
+//   run_start(task, task_id)        right before Task::Run
+//   run_end(task, state)            right after Task::Run, state is TaskState
+//   park(executor, worker)          a worker found the queue empty
+//   unpark(executor, worker)        a parked worker woke up
+//   timer_fire(task, lateness_ns)   a task with a time trigger starts running
+//
+// depth is the executor queue length before the push for submit and after the
+// pop for pop. Reading it takes the queue lock once more; arguments are not
+// evaluated when probes are compiled out.
+//
+// Example: bpftrace -e 'usdt:./libexecutors.so:executors:run_start { @[tid] = count(); }'
+
+#if defined(EXECUTORS_USDT) && EXECUTORS_USDT && __has_include(<sys/sdt.h>)
+
+#include <sys/sdt.h>
+
+#define EXECUTORS_PROBE2(name, arg1, arg2) DTRACE_PROBE2(executors, name, arg1, arg2)
+#define EXECUTORS_PROBE3(name, arg1, arg2, arg3) \
+    DTRACE_PROBE3(executors, name, arg1, arg2, arg3)
+
+#else
+
+#define EXECUTORS_PROBE2(name, arg1, arg2) \
+    do {                                   \
+    } while (false)
+
+#define EXECUTORS_PROBE3(name, arg1, arg2, arg3) \
+    do {                                         \
+    } while (false)
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "executors/counters.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+std::string DemangleTypeName(const char* name);
+
+struct TaskTypeCounters {
+    bool is_label = false;
+    uint64_t count = 0;
+    uint64_t failures = 0;
+    uint64_t cancellations = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t cpu_ns = 0;
+};
+
+// Keyed by the task label or by std::type_info::name() of the task, both are
+// static strings. The mutex is only contended while a report is built.
+struct alignas(kCacheLineSize) WorkerProfile {
+    std::mutex mutex;
+    std::unordered_map<const char*, TaskTypeCounters> entries;
+
+    void RecordRun(const char* key, bool is_label, uint64_t run_ns, uint64_t cpu_ns, bool failed);
+
+    void RecordCancel(const char* key, bool is_label);
+};
+
+struct TaskTypeProfile {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t failures = 0;
+    uint64_t cancellations = 0;
+    std::chrono::nanoseconds total_time{0};
+    std::chrono::nanoseconds mean_time{0};
+    std::chrono::nanoseconds max_time{0};
+    // Zero unless ExecutorOptions::measure_cpu_time is set
+    std::chrono::nanoseconds cpu_time{0};
+};
+
+// Sorted by total_time, largest first
+std::vector<TaskTypeProfile> MergeProfiles(std::vector<WorkerProfile>& workers);
+
+void WriteProfile(std::ostream& out, const std::vector<TaskTypeProfile>& profile);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "executors/stats.h"
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+struct RecordedTask {
+    // Since the first recorded submit
+    std::chrono::nanoseconds submitted_at{0};
+    // Relative to submitted_at, negative if the trigger was already due
+    std::optional<std::chrono::nanoseconds> time_trigger;
+    bool executed = false;
+    std::chrono::nanoseconds run_time{0};
+    // Distinct indices into the recorded graph, edges to tasks that were never
+    // submitted are dropped
+    std::vector<size_t> dependencies;
+    std::vector<size_t> triggers;
+};
+
+using RecordedGraph = std::vector<RecordedTask>;
+
+// Compact varint encoding, tasks in submit order
+void WriteGraph(std::ostream& out, const RecordedGraph& graph);
+
+// Throws std::runtime_error on malformed input
+RecordedGraph ReadGraph(std::istream& in);
+
+// Shape and run times of every task submitted to an executor
+class GraphRecorder {
+public:
+    explicit GraphRecorder(bool enabled) : enabled_(enabled) {
+    }
+
+    bool IsEnabled() const noexcept {
+        return enabled_;
+    }
+
+    // Repeated submits of the same task keep the first one
+    void RecordSubmit(uint64_t task_id, StatsClock::time_point at,
+                      std::optional<std::chrono::nanoseconds> time_trigger,
+                      std::vector<uint64_t> dependencies, std::vector<uint64_t> triggers);
+
+    void RecordRun(uint64_t task_id, std::chrono::nanoseconds run_time);
+
+    RecordedGraph Collect() const;
+
+    // Drops every recorded task, later edges to them are dropped as well
+    void Clear();
+
+private:
+    struct Entry {
+        StatsClock::time_point submitted_at;
+        std::optional<std::chrono::nanoseconds> time_trigger;
+        bool executed = false;
+        std::chrono::nanoseconds run_time{0};
+        std::vector<uint64_t> dependencies;
+        std::vector<uint64_t> triggers;
+    };
+
+    const bool enabled_;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, size_t> index_;
+    std::vector<Entry> entries_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "executors/executors.h"
+
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Runs tasks on the calling thread in an order chosen by a seeded random
+// generator, against a virtual clock that jumps straight to the next time
+// trigger whenever nothing else is ready. The same seed and submission
+// sequence always produce the same execution order.
+//
+// Nothing runs until Step, RunUntil or RunUntilIdle is called, so do not Wait
+// on a task before that. Time triggers must be set relative to Now().
+class SimulatedExecutor : public FutureCombinators<SimulatedExecutor> {
+public:
+    explicit SimulatedExecutor(uint64_t seed, TimePoint start = Clock::now());
+
+    SimulatedExecutor(const SimulatedExecutor&) = delete;
+    SimulatedExecutor& operator=(const SimulatedExecutor&) = delete;
+
+    void Submit(TaskSharedPtr task) noexcept;
+
+    // Like Executor::SchedulePeriodic, ticks follow virtual time
+    std::shared_ptr<PeriodicTask> SchedulePeriodic(std::function<void()> fn,
+                                                   std::chrono::nanoseconds period,
+                                                   PeriodicOptions options = {});
+
+    TimePoint Now() const noexcept {
+        return now_;
+    }
+
+    // Runs one task, advancing virtual time if needed; false when no task can make progress
+    bool Step();
+
+    // Runs every task that becomes ready up to deadline, then sets the clock to it
+    size_t RunUntil(TimePoint deadline);
+
+    // Returns the number of tasks run; stops once only periodic tasks are armed,
+    // RunUntil advances those
+    size_t RunUntilIdle();
+
+    uint64_t GetExecutedCount() const noexcept {
+        return executed_;
+    }
+
+    // Cancels every pending task
+    ~SimulatedExecutor();
+
+private:
+    struct Timer {
+        TimePoint at;
+        uint64_t sequence;
+        TaskSharedPtr task;
+
+        bool operator>(const Timer& other) const noexcept {
+            return at != other.at ? at > other.at : sequence > other.sequence;
+        }
+    };
+
+    // With only_periodic_idle, periodic timers alone do not advance the clock
+    bool StepUntil(TimePoint limit, bool only_periodic_idle = false);
+
+    // Files a pending task under ready, timers or the dependency it waits for
+    void Park(TaskSharedPtr task);
+
+    void Wake(const Task& finished);
+
+    // Picks up dependencies canceled outside the simulation, false if none were
+    bool Rescan();
+
+    std::mt19937_64 random_;
+    TimePoint now_;
+    uint64_t executed_ = 0;
+    uint64_t timer_sequence_ = 0;
+    // Entries of timers_ that hold periodic tasks
+    size_t periodic_timers_ = 0;
+
+    std::vector<TaskSharedPtr> ready_;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    std::unordered_map<const Task*, std::vector<TaskSharedPtr>> waiters_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "executors/contention.h"
+#include "executors/counters.h"
+#include "executors/histogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using StatsClock = std::chrono::steady_clock;
+
+inline uint64_t NanosecondsBetween(StatsClock::time_point from, StatsClock::time_point to) noexcept {
+    if (to <= from) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+struct alignas(kCacheLineSize) WorkerCounters {
+    std::atomic<uint64_t> executed = 0;
+    std::atomic<uint64_t> failed = 0;
+    std::atomic<uint64_t> canceled = 0;
+    std::atomic<uint64_t> requeued = 0;
+    std::atomic<uint64_t> parks = 0;
+    std::atomic<uint64_t> unparks = 0;
+    std::atomic<uint64_t> timer_wakeups = 0;
+    std::atomic<uint64_t> busy_ns = 0;
+    std::atomic<uint64_t> idle_ns = 0;
+    std::atomic<uint64_t> cpu_ns = 0;
+    std::atomic<uint64_t> spin_ns = 0;
+};
+
+struct alignas(kCacheLineSize) SubmitCounters {
+    std::atomic<uint64_t> submitted = 0;
+    std::atomic<uint64_t> rejected = 0;
+};
+
+struct alignas(kCacheLineSize) WorkerHistograms {
+    LatencyHistogram queue_wait;
+    LatencyHistogram run_time;
+};
+
+struct WorkerStats {
+    uint64_t executed = 0;
+    uint64_t failed = 0;
+    uint64_t canceled = 0;
+    uint64_t requeued = 0;
+    uint64_t parks = 0;
+    uint64_t unparks = 0;
+    // Batches of due timers released, coalesced timers share one
+    uint64_t timer_wakeups = 0;
+    std::chrono::nanoseconds busy_time{0};
+    std::chrono::nanoseconds idle_time{0};
+    // CPU time of task bodies, zero unless ExecutorOptions::measure_cpu_time is set
+    std::chrono::nanoseconds cpu_time{0};
+    // Spent spinning for precise time triggers, at most spin_margin per wake-up
+    std::chrono::nanoseconds spin_time{0};
+
+    void Load(const WorkerCounters& counters) noexcept;
+
+    WorkerStats& operator+=(const WorkerStats& other) noexcept;
+};
+
+struct ExecutorStats {
+    uint64_t submitted = 0;
+    uint64_t rejected = 0;
+    size_t queue_depth = 0;
+    // Tasks waiting only for their time trigger
+    size_t pending_timers = 0;
+
+    WorkerStats total;
+    std::vector<WorkerStats> workers;
+
+    LockStats queue_lock;
+    // Task mutexes are shared by all executors in the process, acquisitions are not counted
+    LockStats task_execute_lock;
+    LockStats task_wait_lock;
+    LockStats task_other_lock;
+
+    // Empty when built without EXECUTORS_LATENCY_HISTOGRAMS
+    HistogramSnapshot queue_wait;
+    HistogramSnapshot run_time;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "executors/stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+enum class TraceEventType : uint64_t { Submit, Ready, Run, Cancel, Edge };
+
+struct TraceEvent {
+    TraceEventType type = TraceEventType::Submit;
+    uint64_t thread = 0;
+    uint64_t task_id = 0;
+    // Nanoseconds since the tracer was created
+    uint64_t timestamp = 0;
+    // Duration for Run, dependency id for Edge
+    uint64_t arg = 0;
+    // Static string, the task label or std::type_info::name()
+    const char* name = nullptr;
+    bool is_label = false;
+};
+
+// Fixed-size lock-free ring, the oldest events are overwritten. Every slot is
+// guarded by a sequence number that a writer claims with a CAS, so two writers
+// never share a slot and a reader skips slots that are being written.
+class TraceRing {
+public:
+    explicit TraceRing(size_t capacity);
+
+    void Record(const TraceEvent& event) noexcept;
+
+    void Collect(std::vector<TraceEvent>* events) const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence = 0;
+        std::atomic<uint64_t> type_and_thread = 0;
+        std::atomic<uint64_t> task_id = 0;
+        std::atomic<uint64_t> timestamp = 0;
+        std::atomic<uint64_t> arg = 0;
+        std::atomic<const char*> name = nullptr;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    alignas(kCacheLineSize) std::atomic<uint64_t> head_ = 0;
+};
+
+class Tracer {
+public:
+    // capacity is per ring, rounded up to a power of two; zero disables tracing
+    Tracer(size_t workers, size_t capacity);
+
+    bool IsEnabled() const noexcept {
+        return !rings_.empty();
+    }
+
+    // Ring used by threads that are not workers of the executor
+    size_t ExternalThread() const noexcept {
+        return workers_;
+    }
+
+    uint64_t Since(StatsClock::time_point at) const noexcept {
+        return NanosecondsBetween(origin_, at);
+    }
+
+    void Record(size_t thread, TraceEventType type, uint64_t task_id, StatsClock::time_point at,
+                uint64_t arg = 0, const char* name = nullptr, bool is_label = false) noexcept {
+        rings_[thread]->Record({type, thread, task_id, Since(at), arg, name, is_label});
+    }
+
+    std::vector<TraceEvent> Collect() const;
+
+    // Chrome Trace Event format, loadable by chrome://tracing and Perfetto
+    void WriteChromeTrace(std::ostream& out) const;
+
+private:
+    StatsClock::time_point origin_;
+    size_t workers_;
+    std::vector<std::unique_ptr<TraceRing>> rings_;
+};
@@ -1,9 +1,13 @@
 #pragma once
 
+#include "executors/contention.h"
+#include "executors/probes.h"
+
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <optional>
-#include <queue>
+#include <deque>
 
 template <typename T>
 class Queue {
@@ -11,35 +15,126 @@ public:
     Queue() = default;
 
     bool Push(T value) noexcept {
-        auto lock = std::scoped_lock{mutex_};
+        auto lock = Lock();
         if (is_canceled_) {
             return false;
         }
-        data_.push(std::move(value));
+        data_.push_back(std::move(value));
+        EXECUTORS_PROBE2(queue_push, this, data_.size());
         not_empty_.notify_one();
+        // The timer waiter only takes data the other waiters can't
+        if (has_timer_waiter_ && data_.size() > waiting_) {
+            timer_cv_.notify_one();
+        }
         return true;
     }
 
     std::optional<T> Pop() noexcept {
-        auto lock = std::unique_lock{mutex_};
+        auto lock = Lock();
         not_empty_.wait(lock, [this] { return is_canceled_ || !data_.empty(); });
         if (is_canceled_ && data_.empty()) {
             return std::nullopt;
         }
         T result = std::move(data_.front());
-        data_.pop();
+        data_.pop_front();
+        EXECUTORS_PROBE2(queue_pop, this, data_.size());
+        return result;
+    }
+
+    // Like Pop, but one of the callers at a time is the timer waiter: it also
+    // returns nullopt after an Interrupt or at the deadline returned by
+    // deadline_fn, an optional steady_clock time point. The others wait for data
+    // only and take over the role once it is free. deadline_fn runs under the
+    // queue lock, so a deadline change followed by Interrupt is never missed.
+    template <typename F>
+    std::optional<T> PopUntil(F&& deadline_fn) noexcept {
+        auto lock = Lock();
+        while (has_timer_waiter_ && data_.empty() && !is_canceled_) {
+            ++waiting_;
+            not_empty_.wait(lock);
+            --waiting_;
+        }
+        if (data_.empty() && !is_canceled_) {
+            has_timer_waiter_ = true;
+            auto interrupts = interrupts_;
+            std::optional<std::chrono::steady_clock::time_point> deadline = deadline_fn();
+            auto ready = [&] {
+                return is_canceled_ || !data_.empty() || interrupts_ != interrupts;
+            };
+            if (deadline) {
+                timer_cv_.wait_until(lock, *deadline, ready);
+            } else {
+                timer_cv_.wait(lock, ready);
+            }
+            has_timer_waiter_ = false;
+            // Leaving with data keeps this worker busy, hand the role over
+            if (!data_.empty() && waiting_ > 0) {
+                not_empty_.notify_one();
+            }
+        }
+        if (data_.empty()) {
+            return std::nullopt;
+        }
+        T result = std::move(data_.front());
+        data_.pop_front();
+        EXECUTORS_PROBE2(queue_pop, this, data_.size());
+        return result;
+    }
+
+    // Wakes the PopUntil timer waiter without queueing anything
+    void Interrupt() noexcept {
+        auto lock = Lock();
+        ++interrupts_;
+        timer_cv_.notify_one();
+    }
+
+    // Lets a PopUntil waiter take over the timer wait while the caller is busy
+    void HandOffTimerWait() noexcept {
+        auto lock = Lock();
+        if (!has_timer_waiter_ && waiting_ > 0) {
+            not_empty_.notify_one();
+        }
+    }
+
+    std::optional<T> TryPop() noexcept {
+        auto lock = Lock();
+        if (data_.empty()) {
+            return std::nullopt;
+        }
+        T result = std::move(data_.front());
+        data_.pop_front();
+        EXECUTORS_PROBE2(queue_pop, this, data_.size());
         return result;
     }
 
+    // Visits every queued element under the queue lock
+    template <typename F>
+    void ForEach(F&& fn) const {
+        auto lock = Lock();
+        for (const auto& value : data_) {
+            fn(value);
+        }
+    }
+
+    size_t Size() const noexcept {
+        auto lock = Lock();
+        return data_.size();
+    }
+
     bool IsCanceled() const noexcept {
-        auto lock = std::scoped_lock{mutex_};
+        auto lock = Lock();
         return is_canceled_;
     }
 
     void Cancel() noexcept {
-        auto lock = std::scoped_lock{mutex_};
+        auto lock = Lock();
         is_canceled_ = true;
         not_empty_.notify_all();
+        timer_cv_.notify_all();
+    }
+
+    const LockCounters& GetLockCounters() const noexcept {
+        return lock_counters_;
     }
 
     ~Queue() {
@@ -47,10 +142,22 @@ public:
     }
 
 private:
-    std::queue<T> data_;
+    std::unique_lock<std::mutex> Lock() const {
+        auto lock = LockProfiled(mutex_, lock_counters_);
+        Bump(lock_counters_.acquisitions);
+        return lock;
+    }
+
+    std::deque<T> data_;
 
     mutable std::mutex mutex_;
+    mutable LockCounters lock_counters_;
     std::condition_variable not_empty_;
+    std::condition_variable timer_cv_;
 
     bool is_canceled_ = false;
+    uint64_t interrupts_ = 0;
+    bool has_timer_waiter_ = false;
+    // PopUntil callers waiting on not_empty_
+    size_t waiting_ = 0;
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+
+struct StallReport {
+    enum class Kind { LongRunning, NeverReady };
+
+    Kind kind = Kind::LongRunning;
+    uint64_t task_id = 0;
+    // Task label or demangled type name
+    std::string name;
+    // How long the task has been running or waiting since Submit
+    std::chrono::nanoseconds age{0};
+    // Only set for LongRunning
+    size_t worker = 0;
+    std::thread::id thread;
+    // Only set for NeverReady
+    size_t unfinished_dependencies = 0;
+};
+
+std::ostream& operator<<(std::ostream& out, const StallReport& report);
+
+struct WatchdogOptions {
+    // How often workers and the queue are inspected, zero disables the watchdog
+    std::chrono::milliseconds period{0};
+    std::chrono::milliseconds running_threshold{1000};
+    std::chrono::milliseconds pending_threshold{10000};
+    // Called from the watchdog thread once per stalled task, logs to stderr by default
+    std::function<void(const StallReport&)> on_stall;
+};
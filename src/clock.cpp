@@ -0,0 +1,9 @@
+#include "executors/clock.h"
+
+#include <ctime>
+
+TimePoint CoarseClockNow() noexcept {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return TimePoint(std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec));
+}
@@ -1,18 +1,94 @@
 #include "executors/executors.h"
 
+#include <algorithm>
+#include <bit>
+#include <ctime>
+#include <limits>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace {
+
+constexpr uint64_t kTaskIdBlock = 1024;
+
+constexpr auto kCustomClockPoll = std::chrono::milliseconds(10);
+
+std::atomic<uint64_t> next_task_id_block = 0;
+
+thread_local const Executor* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+
+// Set by workers of executors with measure_cpu_time, filled by Task::TryExecute
+thread_local bool measure_cpu_time = false;
+thread_local uint64_t last_cpu_ns = 0;
+
+uint64_t ThreadCpuNanoseconds() noexcept {
+    timespec now{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+}
+
+// Rounds at up to a multiple of the largest power of two not above slack, so
+// timers whose windows overlap mostly land on the same instant
+TimePoint CoalescedDeadline(TimePoint at, std::chrono::nanoseconds slack) noexcept {
+    if (slack.count() <= 0) {
+        return at;
+    }
+    auto grid = static_cast<int64_t>(std::bit_floor(static_cast<uint64_t>(slack.count())));
+    auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(at.time_since_epoch());
+    // Deadlines near TimePoint::max() are left as is, rounding them up would overflow
+    if (since_epoch.count() > std::numeric_limits<int64_t>::max() - (grid - 1)) {
+        return at;
+    }
+    auto rounded = (since_epoch.count() + grid - 1) / grid * grid;
+    return TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::nanoseconds(rounded)));
+}
+
+const char* ProfileKey(const Task& task) {
+    auto label = task.GetLabel();
+    return label != nullptr ? label : typeid(task).name();
+}
+
+}  // namespace
+
+uint64_t Task::NextId() noexcept {
+    thread_local uint64_t next = 0;
+    thread_local uint64_t last = 0;
+    if (next == last) {
+        next = next_task_id_block.fetch_add(kTaskIdBlock, std::memory_order_relaxed) + 1;
+        last = next + kTaskIdBlock;
+    }
+    return next++;
+}
+
+LockCounters Task::execute_lock_counters_;
+LockCounters Task::wait_lock_counters_;
+LockCounters Task::other_lock_counters_;
+std::atomic<uint64_t> Task::periodic_cancels_ = 0;
+
 void Task::AddDependency(TaskSharedPtr dep) noexcept {
-    auto lock = std::scoped_lock{mutex_};
+    auto lock = LockProfiled(mutex_, other_lock_counters_);
     dependencies_.push_back(dep);
 }
 
 void Task::AddTrigger(TaskSharedPtr dep) noexcept {
-    auto lock = std::scoped_lock{mutex_};
+    auto lock = LockProfiled(mutex_, other_lock_counters_);
     triggers_.push_back(dep);
 }
 
-void Task::SetTimeTrigger(TimePoint at) noexcept {
-    auto lock = std::scoped_lock{mutex_};
+void Task::SetTimeTrigger(TimePoint at, std::chrono::nanoseconds slack) noexcept {
+    auto lock = LockProfiled(mutex_, other_lock_counters_);
     time_trigger_ = at;
+    time_slack_ = std::max(slack, std::chrono::nanoseconds{0});
+    precise_timer_ = false;
+}
+
+void Task::SetPreciseTimeTrigger(TimePoint at) noexcept {
+    auto lock = LockProfiled(mutex_, other_lock_counters_);
+    time_trigger_ = at;
+    time_slack_ = {};
+    precise_timer_ = true;
 }
 
 bool Task::IsPending() const noexcept {
@@ -37,50 +113,127 @@ bool Task::IsFinished() const noexcept {
 }
 
 std::exception_ptr Task::GetError() const noexcept {
-    auto lock = std::scoped_lock{mutex_};
+    auto lock = LockProfiled(mutex_, wait_lock_counters_);
     return exception_;
 }
 
-void Task::TryExecute() {
-    auto lock = std::scoped_lock{mutex_};
+bool Task::DependenciesSatisfied() const noexcept {
     for (const auto& task : dependencies_) {
         if (!task->IsFinished()) {
-            return;
+            return false;
         }
     }
     bool is_trigger_happened = triggers_.empty();
     for (const auto& task : triggers_) {
         is_trigger_happened |= task->IsFinished();
     }
-    if (!is_trigger_happened) {
-        return;
+    return is_trigger_happened;
+}
+
+bool Task::TryExecute() {
+    return Execute(&Clock::now) == ExecuteResult::Executed;
+}
+
+Task::ExecuteResult Task::Execute(ClockFunction clock, std::optional<TimePoint> now) {
+    auto lock = LockProfiled(mutex_, execute_lock_counters_);
+    if (!DependenciesSatisfied()) {
+        return ExecuteResult::Blocked;
     }
-    if (Clock::now() < time_trigger_) {
-        return;
+    bool has_time_trigger = time_trigger_ != TimePoint::min();
+    if (has_time_trigger) {
+        if (!now) {
+            now = clock();
+        }
+        if (*now < time_trigger_) {
+            return IsPending() ? ExecuteResult::Timer : ExecuteResult::NotPending;
+        }
     }
     auto state = state_.load();
     if (state != TaskState::Pending) {
-        return;
+        return ExecuteResult::NotPending;
     }
     while (!state_.compare_exchange_weak(state, TaskState::Running)) {
         auto state = state_.load();
         if (state != TaskState::Pending) {
-            return;
+            return ExecuteResult::NotPending;
         }
     }
+    if constexpr (kLatencyHistograms) {
+        started_at_ = StatsClock::now();
+        ready_at_ = ReadyTime(has_time_trigger ? now : std::nullopt);
+    }
+    if (has_time_trigger) {
+        EXECUTORS_PROBE2(timer_fire, this,
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(*now - time_trigger_)
+                             .count());
+    }
+    EXECUTORS_PROBE2(run_start, this, id_);
+    uint64_t cpu_start = measure_cpu_time ? ThreadCpuNanoseconds() : 0;
     try {
         this->Run();
     } catch (...) {
+        if (measure_cpu_time) {
+            last_cpu_ns = ThreadCpuNanoseconds() - cpu_start;
+        }
+        if constexpr (kLatencyHistograms) {
+            finished_at_ = StatsClock::now();
+        }
+        EXECUTORS_PROBE2(run_end, this, static_cast<int>(TaskState::Failed));
         state_ = TaskState::Failed;
         exception_ = std::current_exception();
         cv_.notify_all();
-        return;
+        return ExecuteResult::Executed;
     }
+    if constexpr (kLatencyHistograms) {
+        finished_at_ = StatsClock::now();
+    }
+    if (measure_cpu_time) {
+        last_cpu_ns = ThreadCpuNanoseconds() - cpu_start;
+    }
+    if (periodic_) {
+        EXECUTORS_PROBE2(run_end, this, static_cast<int>(TaskState::Pending));
+        // Pairs with Cancel, which requests first and then checks for Pending
+        state_ = TaskState::Pending;
+        if (cancel_requested_) {
+            Cancel();
+        }
+        return ExecuteResult::Executed;
+    }
+    EXECUTORS_PROBE2(run_end, this, static_cast<int>(TaskState::Completed));
     state_ = TaskState::Completed;
     cv_.notify_all();
+    return ExecuteResult::Executed;
+}
+
+std::string Task::GetName() const {
+    return label_ != nullptr ? label_ : DemangleTypeName(typeid(*this).name());
+}
+
+StatsClock::time_point Task::ReadyTime(std::optional<TimePoint> now) const noexcept {
+    auto ready_at = submitted_at_;
+    if (now) {
+        ready_at = std::max(ready_at, started_at_ - (*now - time_trigger_));
+    }
+    for (const auto& task : dependencies_) {
+        ready_at = std::max(ready_at, task->finished_at_);
+    }
+    if (!triggers_.empty()) {
+        auto first_trigger = StatsClock::time_point::max();
+        for (const auto& task : triggers_) {
+            if (task->IsFinished()) {
+                first_trigger = std::min(first_trigger, task->finished_at_);
+            }
+        }
+        ready_at = std::max(ready_at, first_trigger);
+    }
+    return std::min(ready_at, started_at_);
 }
 
 void Task::Cancel() noexcept {
+    if (periodic_) {
+        cancel_requested_ = true;
+        periodic_cancels_.fetch_add(1, std::memory_order_relaxed);
+    }
     auto state = state_.load();
     if (state != TaskState::Pending) {
         return;
@@ -95,10 +248,384 @@ void Task::Cancel() noexcept {
 }
 
 void Task::Wait() noexcept {
-    auto lock = std::unique_lock{mutex_};
+    auto lock = LockProfiled(mutex_, wait_lock_counters_);
     cv_.wait(lock, [this]() -> bool { return IsFinished(); });
 }
 
-std::shared_ptr<Executor> MakeThreadPoolExecutor(int num_threads) {
-    return std::make_shared<Executor>(num_threads);
+PeriodicTask::PeriodicTask(std::function<void()> fn, std::chrono::nanoseconds period,
+                           PeriodicOptions options)
+    : fn_(std::move(fn)),
+      period_(std::chrono::duration_cast<TimePoint::duration>(period)),
+      options_(options) {
+    periodic_ = true;
+    SetLabel(options_.label);
+}
+
+void PeriodicTask::Arm(TimePoint now) noexcept {
+    tick_ = options_.start.value_or(now + period_);
+    SetTrigger(tick_);
+}
+
+void PeriodicTask::Rearm(TimePoint now) noexcept {
+    if (options_.mode == PeriodicMode::FixedDelay) {
+        tick_ = now + period_;
+        SetTrigger(tick_);
+        return;
+    }
+    tick_ += period_;
+    if (tick_ < now && options_.missed_ticks != MissedTickPolicy::CatchUp) {
+        // Ticks in [tick_, now), the last of them is run by Coalesce; a tick at now is due
+        auto missed = (now - tick_ + period_ - TimePoint::duration(1)) / period_;
+        if (options_.missed_ticks == MissedTickPolicy::Skip) {
+            tick_ += missed * period_;
+            missed_ticks_.fetch_add(missed, std::memory_order_relaxed);
+        } else {
+            tick_ += (missed - 1) * period_;
+            missed_ticks_.fetch_add(missed - 1, std::memory_order_relaxed);
+        }
+    }
+    SetTrigger(tick_);
+}
+
+void PeriodicTask::SetTrigger(TimePoint at) noexcept {
+    if (options_.precise) {
+        SetPreciseTimeTrigger(at);
+    } else {
+        SetTimeTrigger(at, options_.slack);
+    }
+}
+
+std::shared_ptr<PeriodicTask> Executor::SchedulePeriodic(std::function<void()> fn,
+                                                         std::chrono::nanoseconds period,
+                                                         PeriodicOptions options) {
+    if (period.count() <= 0) {
+        throw std::invalid_argument("SchedulePeriodic: period must be positive");
+    }
+    auto task = std::make_shared<PeriodicTask>(std::move(fn), period, options);
+    task->Arm(clock_());
+    Submit(task);
+    return task;
+}
+
+void Executor::WorkerLoop(size_t index) {
+    current_executor = this;
+    current_worker = index;
+    measure_cpu_time = measure_cpu_time_;
+    auto& counters = worker_counters_[index];
+    while (true) {
+        if (next_timer_.load(std::memory_order_relaxed) != kNoTimer) {
+            ReleaseDueTimers(index);
+        }
+        auto task = scheduler_.TryPop();
+        if (!task) {
+            Bump(counters.parks);
+            EXECUTORS_PROBE2(park, this, index);
+            auto idle_start = StatsClock::now();
+            task = scheduler_.PopUntil([this] { return TimerWakeup(); });
+            Bump(counters.idle_ns, NanosecondsBetween(idle_start, StatsClock::now()));
+            Bump(counters.unparks);
+            EXECUTORS_PROBE2(unpark, this, index);
+            if (!task) {
+                if (scheduler_.IsCanceled()) {
+                    return;
+                }
+                continue;
+            }
+        }
+        if (*task) {
+            RunTask(index, std::move(*task));
+        }
+    }
+}
+
+void Executor::RunTask(size_t index, TaskSharedPtr task) {
+    auto& counters = worker_counters_[index];
+    auto& slot = worker_slots_[index];
+    EXECUTORS_PROBE3(pop, task.get(), index, scheduler_.Size());
+    if (task->IsCanceled()) {
+        RecordCanceled(index, *task, StatsClock::now());
+        return;
+    }
+    auto busy_start = StatsClock::now();
+    {
+        auto lock = std::scoped_lock{slot.mutex};
+        slot.task = task;
+        slot.since = busy_start;
+    }
+    auto result = task->Execute(clock_);
+    {
+        auto lock = std::scoped_lock{slot.mutex};
+        slot.task.reset();
+    }
+    auto busy_end = StatsClock::now();
+    Bump(counters.busy_ns, NanosecondsBetween(busy_start, busy_end));
+    if (result == Task::ExecuteResult::Executed) {
+        RecordExecuted(index, *task, busy_start, busy_end);
+        if (task->periodic_ && task->IsPending()) {
+            static_cast<PeriodicTask&>(*task).Rearm(clock_());
+            AddTimer(std::move(task));
+        }
+    } else if (task->IsCanceled()) {
+        RecordCanceled(index, *task, busy_end);
+    } else if (result == Task::ExecuteResult::Timer) {
+        AddTimer(std::move(task));
+    } else if (!task->IsFinished()) {
+        Bump(counters.requeued);
+        if (!scheduler_.Push(task)) {
+            task->Cancel();
+        }
+    }
+}
+
+void Executor::AddTimer(TaskSharedPtr task) {
+    TimePoint at;
+    bool precise = false;
+    {
+        auto lock = LockProfiled(task->mutex_, Task::other_lock_counters_);
+        at = CoalescedDeadline(task->time_trigger_, task->time_slack_);
+        precise = task->precise_timer_ && spin_margin_.count() > 0;
+    }
+    if (precise) {
+        at -= std::chrono::duration_cast<TimePoint::duration>(spin_margin_);
+    }
+    PushTimer({at, std::move(task), precise});
+}
+
+void Executor::PushTimer(TimerEntry entry) {
+    auto at = entry.at;
+    bool earliest = false;
+    {
+        auto lock = std::scoped_lock{timers_mutex_};
+        // StartShutdown cancels the queue before it drains the heap
+        if (scheduler_.IsCanceled()) {
+            entry.task->Cancel();
+            return;
+        }
+        if (entry.task->IsCanceled()) {
+            return;
+        }
+        timers_.push_back(std::move(entry));
+        std::push_heap(timers_.begin(), timers_.end());
+        earliest = timers_.front().at == at;
+        next_timer_.store(timers_.front().at.time_since_epoch().count(),
+                          std::memory_order_relaxed);
+    }
+    // Sleeping workers computed their deadline from the previous earliest timer
+    if (earliest) {
+        scheduler_.Interrupt();
+    }
+}
+
+void Executor::ReleaseDueTimers(size_t index) {
+    if (Task::periodic_cancels_.load(std::memory_order_relaxed) !=
+        pruned_cancels_.load(std::memory_order_relaxed)) {
+        auto lock = std::scoped_lock{timers_mutex_};
+        PruneCanceledTimers();
+    }
+    auto now = clock_();
+    if (now.time_since_epoch().count() < next_timer_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::vector<TaskSharedPtr> due;
+    std::vector<TimerEntry> precise;
+    {
+        auto lock = std::scoped_lock{timers_mutex_};
+        while (!timers_.empty() && timers_.front().at <= now) {
+            std::pop_heap(timers_.begin(), timers_.end());
+            if (timers_.back().precise) {
+                precise.push_back(std::move(timers_.back()));
+            } else {
+                due.push_back(std::move(timers_.back().task));
+            }
+            timers_.pop_back();
+        }
+        next_timer_.store(timers_.empty() ? kNoTimer : timers_.front().at.time_since_epoch().count(),
+                          std::memory_order_relaxed);
+    }
+    if (!due.empty() || !precise.empty()) {
+        Bump(worker_counters_[index].timer_wakeups);
+    }
+    for (auto& task : due) {
+        if (!scheduler_.Push(task)) {
+            task->Cancel();
+        }
+    }
+    if (!precise.empty()) {
+        scheduler_.HandOffTimerWait();
+    }
+    // Entries come off the heap earliest first, each spins at most spin_margin_ so
+    // a clock that stalls sends the task back to an ordinary timer
+    auto margin = std::chrono::duration_cast<TimePoint::duration>(spin_margin_);
+    for (auto& entry : precise) {
+        auto deadline = entry.at + margin;
+        auto spin_start = StatsClock::now();
+        auto spin_end = spin_start + spin_margin_;
+        while (clock_() < deadline && StatsClock::now() < spin_end) {
+        }
+        Bump(worker_counters_[index].spin_ns, NanosecondsBetween(spin_start, StatsClock::now()));
+        if (clock_() >= deadline) {
+            RunTask(index, std::move(entry.task));
+        } else {
+            PushTimer({deadline, std::move(entry.task)});
+        }
+    }
+}
+
+void Executor::PruneCanceledTimers() {
+    auto cancels = Task::periodic_cancels_.load(std::memory_order_relaxed);
+    if (cancels == pruned_cancels_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    pruned_cancels_.store(cancels, std::memory_order_relaxed);
+    auto removed = std::erase_if(timers_, [](const TimerEntry& entry) {
+        return entry.task->periodic_ && entry.task->IsCanceled();
+    });
+    if (removed == 0) {
+        return;
+    }
+    std::make_heap(timers_.begin(), timers_.end());
+    next_timer_.store(timers_.empty() ? kNoTimer : timers_.front().at.time_since_epoch().count(),
+                      std::memory_order_relaxed);
+}
+
+void Executor::CancelTimers() noexcept {
+    std::vector<TimerEntry> timers;
+    {
+        auto lock = std::scoped_lock{timers_mutex_};
+        timers.swap(timers_);
+        next_timer_.store(kNoTimer, std::memory_order_relaxed);
+    }
+    for (auto& timer : timers) {
+        timer.task->Cancel();
+    }
+}
+
+std::optional<StatsClock::time_point> Executor::TimerWakeup() const noexcept {
+    auto next = next_timer_.load(std::memory_order_relaxed);
+    if (next == kNoTimer) {
+        return std::nullopt;
+    }
+    auto wait = TimePoint(TimePoint::duration(next)) - clock_();
+    if (clock_ != &Clock::now) {
+        // Other clocks may jump or lag, poll them instead of trusting the distance
+        wait = std::min<TimePoint::duration>(wait, kCustomClockPoll);
+    }
+    return StatsClock::now() + wait;
+}
+
+void Executor::RecordExecuted(size_t index, Task& task, StatsClock::time_point start,
+                              StatsClock::time_point end) {
+    if constexpr (kLatencyHistograms) {
+        start = task.started_at_;
+        end = task.finished_at_;
+        auto& histograms = worker_histograms_[index];
+        histograms.queue_wait.Record(NanosecondsBetween(task.ready_at_, start));
+        histograms.run_time.Record(NanosecondsBetween(start, end));
+    }
+    auto& counters = worker_counters_[index];
+    Bump(counters.executed);
+    if (task.IsFailed()) {
+        Bump(counters.failed);
+    }
+    uint64_t cpu_ns = measure_cpu_time_ ? last_cpu_ns : 0;
+    Bump(counters.cpu_ns, cpu_ns);
+    if (!worker_profiles_.empty()) {
+        worker_profiles_[index].RecordRun(ProfileKey(task), task.GetLabel() != nullptr,
+                                          NanosecondsBetween(start, end), cpu_ns,
+                                          task.IsFailed());
+    }
+    if (tracer_.IsEnabled()) {
+        TraceExecuted(index, task, start, end);
+    }
+    if (recorder_.IsEnabled()) {
+        recorder_.RecordRun(task.GetId(), std::chrono::nanoseconds(NanosecondsBetween(start, end)));
+    }
+}
+
+void Executor::RecordCanceled(size_t index, const Task& task, StatsClock::time_point at) {
+    Bump(worker_counters_[index].canceled);
+    if (!worker_profiles_.empty()) {
+        worker_profiles_[index].RecordCancel(ProfileKey(task), task.GetLabel() != nullptr);
+    }
+    if (tracer_.IsEnabled()) {
+        tracer_.Record(index, TraceEventType::Cancel, task.GetId(), at);
+    }
+}
+
+void Executor::TraceSubmit(const Task& task, TraceEventType type) noexcept {
+    auto thread = current_executor == this ? current_worker : tracer_.ExternalThread();
+    tracer_.Record(thread, type, task.GetId(), StatsClock::now());
+}
+
+void Executor::RecordSubmit(const Task& task) {
+    std::optional<std::chrono::nanoseconds> time_trigger;
+    std::vector<uint64_t> dependencies;
+    std::vector<uint64_t> triggers;
+    {
+        auto lock = LockProfiled(task.mutex_, Task::other_lock_counters_);
+        if (task.time_trigger_ != TimePoint::min()) {
+            time_trigger = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                task.time_trigger_ - clock_());
+        }
+        for (const auto& dependency : task.dependencies_) {
+            dependencies.push_back(dependency->GetId());
+        }
+        for (const auto& trigger : task.triggers_) {
+            triggers.push_back(trigger->GetId());
+        }
+    }
+    recorder_.RecordSubmit(task.GetId(), task.submitted_at_, time_trigger, std::move(dependencies),
+                           std::move(triggers));
+}
+
+void Executor::TraceExecuted(size_t index, Task& task, StatsClock::time_point start,
+                             StatsClock::time_point end) noexcept {
+    if constexpr (kLatencyHistograms) {
+        tracer_.Record(index, TraceEventType::Ready, task.GetId(), task.ready_at_);
+    }
+    auto label = task.GetLabel();
+    tracer_.Record(index, TraceEventType::Run, task.GetId(), start, NanosecondsBetween(start, end),
+                   label != nullptr ? label : typeid(task).name(), label != nullptr);
+    auto lock = LockProfiled(task.mutex_, Task::other_lock_counters_);
+    for (const auto& dependency : task.dependencies_) {
+        tracer_.Record(index, TraceEventType::Edge, task.GetId(), start, dependency->GetId());
+    }
+    for (const auto& trigger : task.triggers_) {
+        if (trigger->IsFinished()) {
+            tracer_.Record(index, TraceEventType::Edge, task.GetId(), start, trigger->GetId());
+        }
+    }
+}
+
+ExecutorStats Executor::GetStats() const {
+    ExecutorStats stats;
+    stats.submitted = submit_counters_.submitted.load(std::memory_order_relaxed);
+    stats.rejected = submit_counters_.rejected.load(std::memory_order_relaxed);
+    stats.queue_depth = scheduler_.Size();
+    {
+        auto lock = std::scoped_lock{timers_mutex_};
+        // Canceled tasks wait on the heap until the next prune
+        stats.pending_timers = std::count_if(timers_.begin(), timers_.end(),
+                                             [](const TimerEntry& entry) {
+                                                 return !entry.task->IsCanceled();
+                                             });
+    }
+    stats.queue_lock.Load(scheduler_.GetLockCounters());
+    stats.task_execute_lock.Load(Task::execute_lock_counters_);
+    stats.task_wait_lock.Load(Task::wait_lock_counters_);
+    stats.task_other_lock.Load(Task::other_lock_counters_);
+    stats.workers.resize(worker_counters_.size());
+    for (size_t i = 0; i < worker_counters_.size(); ++i) {
+        stats.workers[i].Load(worker_counters_[i]);
+        stats.total += stats.workers[i];
+    }
+    for (const auto& histograms : worker_histograms_) {
+        stats.queue_wait.Merge(histograms.queue_wait);
+        stats.run_time.Merge(histograms.run_time);
+    }
+    return stats;
+}
+
+std::shared_ptr<Executor> MakeThreadPoolExecutor(int num_threads, ExecutorOptions options) {
+    return std::make_shared<Executor>(num_threads, options);
 }
\ No newline at end of file
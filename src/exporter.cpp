@@ -0,0 +1,263 @@
+#include "executors/exporter.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kPollTimeoutMs = 100;
+constexpr int kRequestTimeoutMs = 50;
+
+std::string EscapeLabel(std::string_view value) {
+    std::string result;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+double Seconds(std::chrono::nanoseconds value) {
+    return std::chrono::duration<double>(value).count();
+}
+
+class Writer {
+public:
+    explicit Writer(std::string_view executor) : label_(EscapeLabel(executor)) {
+    }
+
+    void Header(const char* name, const char* type, const char* help) {
+        out_ << "# HELP " << name << ' ' << help << '\n';
+        out_ << "# TYPE " << name << ' ' << type << '\n';
+    }
+
+    template <typename T>
+    void Sample(const char* name, T value, std::string_view extra_labels = {}) {
+        out_ << name << "{executor=\"" << label_ << '"';
+        if (!extra_labels.empty()) {
+            out_ << ',' << extra_labels;
+        }
+        out_ << "} " << value << '\n';
+    }
+
+    template <typename T>
+    void Metric(const char* name, const char* type, const char* help, T value) {
+        Header(name, type, help);
+        Sample(name, value);
+    }
+
+    void Summary(const char* name, const char* help, const HistogramSnapshot& histogram) {
+        Header(name, "summary", help);
+        Sample(name, Seconds(histogram.P50()), "quantile=\"0.5\"");
+        Sample(name, Seconds(histogram.P99()), "quantile=\"0.99\"");
+        Sample(name, Seconds(histogram.P999()), "quantile=\"0.999\"");
+        Sample((std::string(name) + "_sum").c_str(), Seconds(histogram.Sum()));
+        Sample((std::string(name) + "_count").c_str(), histogram.Count());
+    }
+
+    std::string Str() const {
+        return out_.str();
+    }
+
+private:
+    std::string label_;
+    std::ostringstream out_;
+};
+
+void WriteAll(int fd, std::string_view data) {
+    while (!data.empty()) {
+        auto written = ::send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (written <= 0) {
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data.remove_prefix(written);
+    }
+}
+
+}  // namespace
+
+std::string FormatPrometheus(const ExecutorStats& stats, std::string_view executor) {
+    Writer writer(executor);
+    writer.Metric("executor_tasks_submitted_total", "counter", "Tasks accepted by Submit.",
+                  stats.submitted);
+    writer.Metric("executor_tasks_rejected_total", "counter",
+                  "Tasks canceled by Submit after shutdown.", stats.rejected);
+    writer.Metric("executor_tasks_executed_total", "counter", "Task bodies run by workers.",
+                  stats.total.executed);
+    writer.Metric("executor_tasks_failed_total", "counter", "Task bodies that threw.",
+                  stats.total.failed);
+    writer.Metric("executor_tasks_canceled_total", "counter",
+                  "Canceled tasks dropped by workers.", stats.total.canceled);
+    writer.Metric("executor_tasks_requeued_total", "counter",
+                  "Not ready tasks pushed back to the queue.", stats.total.requeued);
+    writer.Metric("executor_worker_parks_total", "counter",
+                  "Times a worker found the queue empty.", stats.total.parks);
+    writer.Metric("executor_timer_wakeups_total", "counter",
+                  "Batches of due time triggers released to the queue.",
+                  stats.total.timer_wakeups);
+    writer.Metric("executor_queue_depth", "gauge", "Tasks currently in the queue.",
+                  stats.queue_depth);
+    writer.Metric("executor_pending_timers", "gauge",
+                  "Tasks waiting only for their time trigger.", stats.pending_timers);
+
+    writer.Header("executor_worker_busy_seconds_total", "counter",
+                  "Time workers spent executing tasks.");
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        writer.Sample("executor_worker_busy_seconds_total", Seconds(stats.workers[i].busy_time),
+                      "worker=\"" + std::to_string(i) + '"');
+    }
+    writer.Header("executor_worker_idle_seconds_total", "counter",
+                  "Time workers spent waiting for tasks.");
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        writer.Sample("executor_worker_idle_seconds_total", Seconds(stats.workers[i].idle_time),
+                      "worker=\"" + std::to_string(i) + '"');
+    }
+
+    writer.Header("executor_worker_cpu_seconds_total", "counter",
+                  "Thread CPU time spent in task bodies.");
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        writer.Sample("executor_worker_cpu_seconds_total", Seconds(stats.workers[i].cpu_time),
+                      "worker=\"" + std::to_string(i) + '"');
+    }
+    writer.Header("executor_worker_spin_seconds_total", "counter",
+                  "Time workers spent spinning for precise time triggers.");
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        writer.Sample("executor_worker_spin_seconds_total", Seconds(stats.workers[i].spin_time),
+                      "worker=\"" + std::to_string(i) + '"');
+    }
+
+    const std::pair<const char*, const LockStats*> locks[] = {
+        {"queue", &stats.queue_lock},
+        {"task_execute", &stats.task_execute_lock},
+        {"task_wait", &stats.task_wait_lock},
+        {"task_other", &stats.task_other_lock}};
+    writer.Header("executor_lock_contended_total", "counter",
+                  "Lock acquisitions that had to wait.");
+    for (const auto& [name, lock] : locks) {
+        writer.Sample("executor_lock_contended_total", lock->contended,
+                      std::string("lock=\"") + name + '"');
+    }
+    writer.Header("executor_lock_wait_seconds_total", "counter",
+                  "Time spent waiting for contended locks.");
+    for (const auto& [name, lock] : locks) {
+        writer.Sample("executor_lock_wait_seconds_total", Seconds(lock->wait_time),
+                      std::string("lock=\"") + name + '"');
+    }
+
+    if (stats.run_time.Count() > 0 || stats.queue_wait.Count() > 0) {
+        writer.Summary("executor_task_queue_wait_seconds",
+                       "Time from readiness to the start of Run.", stats.queue_wait);
+        writer.Summary("executor_task_run_seconds", "Duration of Run.", stats.run_time);
+    }
+    return writer.Str();
+}
+
+MetricsExporter::MetricsExporter(std::function<std::string()> render, ExporterOptions options)
+    : render_(std::move(render)), options_(std::move(options)) {
+    if (!options_.socket_path.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (options_.socket_path.size() >= sizeof(address.sun_path)) {
+            throw std::system_error(ENAMETOOLONG, std::generic_category(), options_.socket_path);
+        }
+        std::strcpy(address.sun_path, options_.socket_path.c_str());
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(), "socket");
+        }
+        ::unlink(options_.socket_path.c_str());
+        if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(listen_fd_, SOMAXCONN) < 0) {
+            auto error = errno;
+            ::close(listen_fd_);
+            throw std::system_error(error, std::generic_category(), options_.socket_path);
+        }
+    }
+    thread_ = std::jthread([this](std::stop_token stop) { Loop(stop); });
+}
+
+MetricsExporter::~MetricsExporter() {
+    thread_.request_stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(options_.socket_path.c_str());
+    }
+}
+
+void MetricsExporter::Loop(std::stop_token stop) {
+    auto next_write = std::chrono::steady_clock::now();
+    while (!stop.stop_requested()) {
+        if (!options_.file_path.empty() && std::chrono::steady_clock::now() >= next_write) {
+            WriteFile();
+            next_write += options_.interval;
+        }
+        if (listen_fd_ < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kPollTimeoutMs));
+            continue;
+        }
+        pollfd listener{listen_fd_, POLLIN, 0};
+        if (::poll(&listener, 1, kPollTimeoutMs) <= 0) {
+            continue;
+        }
+        int client = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client >= 0) {
+            Serve(client);
+            ::close(client);
+        }
+    }
+    if (!options_.file_path.empty()) {
+        WriteFile();
+    }
+}
+
+// Plain clients get the bare exposition text, HTTP clients (curl --unix-socket)
+// get it wrapped into a minimal HTTP/1.0 response
+void MetricsExporter::Serve(int client) {
+    char request[512];
+    ssize_t received = 0;
+    pollfd readable{client, POLLIN, 0};
+    if (::poll(&readable, 1, kRequestTimeoutMs) > 0) {
+        received = ::recv(client, request, sizeof(request), 0);
+    }
+    auto body = render_();
+    if (received >= 4 && std::memcmp(request, "GET ", 4) == 0) {
+        WriteAll(client, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+                         "Content-Length: " +
+                             std::to_string(body.size()) + "\r\n\r\n");
+    }
+    WriteAll(client, body);
+}
+
+void MetricsExporter::WriteFile() {
+    auto temporary = options_.file_path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        if (!out) {
+            return;
+        }
+        out << render_();
+    }
+    std::rename(temporary.c_str(), options_.file_path.c_str());
+}
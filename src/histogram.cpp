@@ -0,0 +1,86 @@
+#include "executors/histogram.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+size_t LatencyHistogram::BucketOf(uint64_t value) noexcept {
+    if (value < kSubBuckets) {
+        return value;
+    }
+    size_t top_bit = std::bit_width(value) - 1;
+    if (top_bit > kMaxBit) {
+        return kBuckets - 1;
+    }
+    size_t shift = top_bit - kSubBucketBits;
+    size_t mantissa = (value >> shift) & (kSubBuckets - 1);
+    return (shift + 1) * kSubBuckets + mantissa;
+}
+
+uint64_t LatencyHistogram::LowerBound(size_t bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    size_t shift = bucket / kSubBuckets - 1;
+    uint64_t mantissa = bucket % kSubBuckets;
+    return (kSubBuckets + mantissa) << shift;
+}
+
+uint64_t LatencyHistogram::UpperBound(size_t bucket) noexcept {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    size_t shift = bucket / kSubBuckets - 1;
+    return LowerBound(bucket) + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) noexcept {
+    Bump(buckets_[BucketOf(value)]);
+    Bump(sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+void HistogramSnapshot::Merge(const LatencyHistogram& histogram) noexcept {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        auto count = histogram.Count(i);
+        buckets_[i] += count;
+        count_ += count;
+    }
+    sum_ += histogram.Sum();
+    max_ = std::max(max_, histogram.Max());
+}
+
+void HistogramSnapshot::Merge(const HistogramSnapshot& other) noexcept {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+std::chrono::nanoseconds HistogramSnapshot::Mean() const noexcept {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    return std::chrono::nanoseconds(sum_ / count_);
+}
+
+std::chrono::nanoseconds HistogramSnapshot::Percentile(double percentile) const noexcept {
+    if (count_ == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(std::min(LatencyHistogram::UpperBound(i), max_));
+        }
+    }
+    return std::chrono::nanoseconds(max_);
+}
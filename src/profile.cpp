@@ -0,0 +1,91 @@
+#include "executors/profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cxxabi.h>
+#include <iomanip>
+#include <map>
+
+std::string DemangleTypeName(const char* name) {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status != 0 || demangled == nullptr) {
+        return name;
+    }
+    std::string result = demangled;
+    std::free(demangled);
+    return result;
+}
+
+void WorkerProfile::RecordRun(const char* key, bool is_label, uint64_t run_ns, uint64_t cpu_ns,
+                              bool failed) {
+    auto lock = std::scoped_lock{mutex};
+    auto& entry = entries[key];
+    entry.is_label = is_label;
+    ++entry.count;
+    entry.failures += failed;
+    entry.total_ns += run_ns;
+    entry.max_ns = std::max(entry.max_ns, run_ns);
+    entry.cpu_ns += cpu_ns;
+}
+
+void WorkerProfile::RecordCancel(const char* key, bool is_label) {
+    auto lock = std::scoped_lock{mutex};
+    auto& entry = entries[key];
+    entry.is_label = is_label;
+    ++entry.cancellations;
+}
+
+std::vector<TaskTypeProfile> MergeProfiles(std::vector<WorkerProfile>& workers) {
+    std::map<std::string, TaskTypeProfile> merged;
+    std::unordered_map<const char*, std::string> names;
+    for (auto& worker : workers) {
+        auto lock = std::scoped_lock{worker.mutex};
+        for (const auto& [key, entry] : worker.entries) {
+            auto name = names.find(key);
+            if (name == names.end()) {
+                name = names.emplace(key, entry.is_label ? key : DemangleTypeName(key)).first;
+            }
+            auto& profile = merged[name->second];
+            profile.name = name->second;
+            profile.count += entry.count;
+            profile.failures += entry.failures;
+            profile.cancellations += entry.cancellations;
+            profile.total_time += std::chrono::nanoseconds(entry.total_ns);
+            profile.max_time = std::max(profile.max_time, std::chrono::nanoseconds(entry.max_ns));
+            profile.cpu_time += std::chrono::nanoseconds(entry.cpu_ns);
+        }
+    }
+
+    std::vector<TaskTypeProfile> result;
+    result.reserve(merged.size());
+    for (auto& [name, profile] : merged) {
+        if (profile.count > 0) {
+            profile.mean_time = profile.total_time / profile.count;
+        }
+        result.push_back(std::move(profile));
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const TaskTypeProfile& lhs, const TaskTypeProfile& rhs) {
+                         return lhs.total_time > rhs.total_time;
+                     });
+    return result;
+}
+
+void WriteProfile(std::ostream& out, const std::vector<TaskTypeProfile>& profile) {
+    auto to_us = [](std::chrono::nanoseconds value) { return value.count() / 1000.0; };
+    auto flags = out.flags();
+    auto precision = out.precision();
+    out << std::left << std::setw(40) << "task" << std::right << std::setw(12) << "count"
+        << std::setw(14) << "total_us" << std::setw(12) << "mean_us" << std::setw(12) << "max_us"
+        << std::setw(14) << "cpu_us" << std::setw(10) << "failed" << std::setw(10) << "canceled" << '\n';
+    out << std::fixed << std::setprecision(1);
+    for (const auto& entry : profile) {
+        out << std::left << std::setw(40) << entry.name << std::right << std::setw(12)
+            << entry.count << std::setw(14) << to_us(entry.total_time) << std::setw(12)
+            << to_us(entry.mean_time) << std::setw(12) << to_us(entry.max_time) << std::setw(14)
+            << to_us(entry.cpu_time) << std::setw(10) << entry.failures << std::setw(10) << entry.cancellations << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
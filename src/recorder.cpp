@@ -0,0 +1,193 @@
+#include "executors/recorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[4] = {'E', 'X', 'G', 'R'};
+constexpr uint64_t kVersion = 1;
+
+constexpr uint64_t kExecutedFlag = 1;
+constexpr uint64_t kTimeTriggerFlag = 2;
+
+// Tasks are reserved up to this count, the rest grows as the input proves to hold them
+constexpr uint64_t kMaxReservedTasks = 1 << 16;
+
+void WriteVarint(std::ostream& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+void WriteSigned(std::ostream& out, int64_t value) {
+    WriteVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+uint64_t ReadVarint(std::istream& in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        auto byte = in.get();
+        if (byte == std::istream::traits_type::eof()) {
+            throw std::runtime_error("Truncated task graph");
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in task graph");
+}
+
+int64_t ReadSigned(std::istream& in) {
+    auto value = ReadVarint(in);
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Edges are stored relative to the task, so most of them fit a single byte
+void WriteEdges(std::ostream& out, size_t index, const std::vector<size_t>& edges) {
+    WriteVarint(out, edges.size());
+    for (auto edge : edges) {
+        WriteSigned(out, static_cast<int64_t>(index) - static_cast<int64_t>(edge));
+    }
+}
+
+// Edges are distinct, so a task has at most size of them
+std::vector<size_t> ReadEdges(std::istream& in, size_t index, uint64_t size) {
+    auto count = ReadVarint(in);
+    if (count > size) {
+        throw std::runtime_error("Too many task graph edges");
+    }
+    std::vector<size_t> edges;
+    edges.reserve(std::min(count, kMaxReservedTasks));
+    for (uint64_t i = 0; i < count; ++i) {
+        auto target = static_cast<int64_t>(index) - ReadSigned(in);
+        if (target < 0 || static_cast<uint64_t>(target) >= size) {
+            throw std::runtime_error("Task graph edge out of range");
+        }
+        edges.push_back(target);
+    }
+    return edges;
+}
+
+}  // namespace
+
+void WriteGraph(std::ostream& out, const RecordedGraph& graph) {
+    out.write(kMagic, sizeof(kMagic));
+    WriteVarint(out, kVersion);
+    WriteVarint(out, graph.size());
+    std::chrono::nanoseconds previous{0};
+    for (size_t i = 0; i < graph.size(); ++i) {
+        const auto& task = graph[i];
+        WriteSigned(out, (task.submitted_at - previous).count());
+        previous = task.submitted_at;
+        WriteVarint(out, (task.executed ? kExecutedFlag : 0) |
+                             (task.time_trigger ? kTimeTriggerFlag : 0));
+        if (task.executed) {
+            WriteVarint(out, task.run_time.count());
+        }
+        if (task.time_trigger) {
+            WriteSigned(out, task.time_trigger->count());
+        }
+        WriteEdges(out, i, task.dependencies);
+        WriteEdges(out, i, task.triggers);
+    }
+}
+
+RecordedGraph ReadGraph(std::istream& in) {
+    char magic[sizeof(kMagic)] = {};
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a task graph");
+    }
+    if (ReadVarint(in) != kVersion) {
+        throw std::runtime_error("Unsupported task graph version");
+    }
+    auto size = ReadVarint(in);
+    if (size > std::numeric_limits<int64_t>::max()) {
+        throw std::runtime_error("Too many tasks in task graph");
+    }
+    RecordedGraph graph;
+    graph.reserve(std::min(size, kMaxReservedTasks));
+    std::chrono::nanoseconds previous{0};
+    for (size_t i = 0; i < size; ++i) {
+        auto& task = graph.emplace_back();
+        task.submitted_at = previous + std::chrono::nanoseconds(ReadSigned(in));
+        previous = task.submitted_at;
+        auto flags = ReadVarint(in);
+        task.executed = flags & kExecutedFlag;
+        if (task.executed) {
+            task.run_time = std::chrono::nanoseconds(ReadVarint(in));
+        }
+        if (flags & kTimeTriggerFlag) {
+            task.time_trigger = std::chrono::nanoseconds(ReadSigned(in));
+        }
+        task.dependencies = ReadEdges(in, i, size);
+        task.triggers = ReadEdges(in, i, size);
+    }
+    return graph;
+}
+
+void GraphRecorder::RecordSubmit(uint64_t task_id, StatsClock::time_point at,
+                                 std::optional<std::chrono::nanoseconds> time_trigger,
+                                 std::vector<uint64_t> dependencies,
+                                 std::vector<uint64_t> triggers) {
+    auto lock = std::scoped_lock{mutex_};
+    if (!index_.emplace(task_id, entries_.size()).second) {
+        return;
+    }
+    entries_.push_back(
+        {at, time_trigger, false, std::chrono::nanoseconds{0}, std::move(dependencies),
+         std::move(triggers)});
+}
+
+void GraphRecorder::RecordRun(uint64_t task_id, std::chrono::nanoseconds run_time) {
+    auto lock = std::scoped_lock{mutex_};
+    auto it = index_.find(task_id);
+    if (it == index_.end()) {
+        return;
+    }
+    entries_[it->second].executed = true;
+    entries_[it->second].run_time = run_time;
+}
+
+RecordedGraph GraphRecorder::Collect() const {
+    auto lock = std::scoped_lock{mutex_};
+    auto remap = [this](const std::vector<uint64_t>& ids) {
+        std::vector<size_t> indices;
+        std::unordered_set<size_t> seen;
+        for (auto id : ids) {
+            auto it = index_.find(id);
+            if (it != index_.end() && seen.insert(it->second).second) {
+                indices.push_back(it->second);
+            }
+        }
+        return indices;
+    };
+    RecordedGraph graph(entries_.size());
+    if (entries_.empty()) {
+        return graph;
+    }
+    auto origin = entries_.front().submitted_at;
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        const auto& entry = entries_[i];
+        auto& task = graph[i];
+        task.submitted_at = entry.submitted_at - origin;
+        task.time_trigger = entry.time_trigger;
+        task.executed = entry.executed;
+        task.run_time = entry.run_time;
+        task.dependencies = remap(entry.dependencies);
+        task.triggers = remap(entry.triggers);
+    }
+    return graph;
+}
+
+void GraphRecorder::Clear() {
+    auto lock = std::scoped_lock{mutex_};
+    index_.clear();
+    entries_.clear();
+}
@@ -0,0 +1,163 @@
+#include "executors/simulated.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+SimulatedExecutor::SimulatedExecutor(uint64_t seed, TimePoint start)
+    : random_(seed), now_(start) {
+}
+
+void SimulatedExecutor::Submit(TaskSharedPtr task) noexcept {
+    if (task->IsPending()) {
+        task->submitted_at_ = StatsClock::now();
+        Park(std::move(task));
+    }
+}
+
+std::shared_ptr<PeriodicTask> SimulatedExecutor::SchedulePeriodic(std::function<void()> fn,
+                                                                  std::chrono::nanoseconds period,
+                                                                  PeriodicOptions options) {
+    if (period.count() <= 0) {
+        throw std::invalid_argument("SchedulePeriodic: period must be positive");
+    }
+    auto task = std::make_shared<PeriodicTask>(std::move(fn), period, options);
+    task->Arm(now_);
+    Submit(task);
+    return task;
+}
+
+bool SimulatedExecutor::Step() {
+    return StepUntil(TimePoint::max());
+}
+
+size_t SimulatedExecutor::RunUntil(TimePoint deadline) {
+    size_t executed = 0;
+    while (StepUntil(deadline)) {
+        ++executed;
+    }
+    now_ = std::max(now_, deadline);
+    return executed;
+}
+
+size_t SimulatedExecutor::RunUntilIdle() {
+    size_t executed = 0;
+    while (StepUntil(TimePoint::max(), true)) {
+        ++executed;
+    }
+    return executed;
+}
+
+bool SimulatedExecutor::StepUntil(TimePoint limit, bool only_periodic_idle) {
+    while (true) {
+        if (ready_.empty()) {
+            bool idle = only_periodic_idle && timers_.size() == periodic_timers_;
+            if (!timers_.empty() && timers_.top().at <= limit && !idle) {
+                now_ = std::max(now_, timers_.top().at);
+                while (!timers_.empty() && timers_.top().at <= now_) {
+                    periodic_timers_ -= timers_.top().task->periodic_;
+                    ready_.push_back(timers_.top().task);
+                    timers_.pop();
+                }
+                continue;
+            }
+            if (!Rescan()) {
+                return false;
+            }
+            continue;
+        }
+        std::swap(ready_[random_() % ready_.size()], ready_.back());
+        auto task = std::move(ready_.back());
+        ready_.pop_back();
+        if (!task->IsPending()) {
+            Wake(*task);
+            continue;
+        }
+        if (task->Execute(&Clock::now, now_) != Task::ExecuteResult::Executed) {
+            Park(std::move(task));
+            continue;
+        }
+        ++executed_;
+        if (task->periodic_ && task->IsPending()) {
+            static_cast<PeriodicTask&>(*task).Rearm(now_);
+            Park(std::move(task));
+            return true;
+        }
+        Wake(*task);
+        return true;
+    }
+}
+
+void SimulatedExecutor::Park(TaskSharedPtr task) {
+    auto lock = LockProfiled(task->mutex_, Task::other_lock_counters_);
+    if (!task->IsPending()) {
+        ready_.push_back(std::move(task));
+        return;
+    }
+    for (const auto& dependency : task->dependencies_) {
+        if (!dependency->IsFinished()) {
+            waiters_[dependency.get()].push_back(std::move(task));
+            return;
+        }
+    }
+    bool triggered = task->triggers_.empty();
+    for (const auto& trigger : task->triggers_) {
+        triggered |= trigger->IsFinished();
+    }
+    if (!triggered) {
+        // Woken by whichever trigger finishes first, the rest find it no longer pending
+        for (const auto& trigger : task->triggers_) {
+            waiters_[trigger.get()].push_back(task);
+        }
+        return;
+    }
+    if (task->time_trigger_ > now_) {
+        periodic_timers_ += task->periodic_;
+        timers_.push({task->time_trigger_, timer_sequence_++, std::move(task)});
+        return;
+    }
+    ready_.push_back(std::move(task));
+}
+
+void SimulatedExecutor::Wake(const Task& finished) {
+    auto it = waiters_.find(&finished);
+    if (it == waiters_.end()) {
+        return;
+    }
+    for (auto& task : it->second) {
+        if (task->IsPending()) {
+            ready_.push_back(std::move(task));
+        }
+    }
+    waiters_.erase(it);
+}
+
+bool SimulatedExecutor::Rescan() {
+    std::vector<const Task*> finished;
+    for (const auto& [task, waiters] : waiters_) {
+        if (task->IsFinished()) {
+            finished.push_back(task);
+        }
+    }
+    for (auto task : finished) {
+        Wake(*task);
+    }
+    // The map iterates in address order, restore a reproducible one
+    std::sort(ready_.begin(), ready_.end(),
+              [](const auto& a, const auto& b) { return a->GetId() < b->GetId(); });
+    return !ready_.empty();
+}
+
+SimulatedExecutor::~SimulatedExecutor() {
+    for (auto& task : ready_) {
+        task->Cancel();
+    }
+    while (!timers_.empty()) {
+        timers_.top().task->Cancel();
+        timers_.pop();
+    }
+    for (auto& [dependency, waiters] : waiters_) {
+        for (auto& task : waiters) {
+            task->Cancel();
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#include "executors/executors.h"
+
+namespace {
+
+const char* StateName(SnapshotState state) {
+    switch (state) {
+        case SnapshotState::Pending:
+            return "pending";
+        case SnapshotState::Ready:
+            return "ready";
+        default:
+            return "running";
+    }
+}
+
+}  // namespace
+
+std::ostream& operator<<(std::ostream& out, const TaskSnapshot& snapshot) {
+    auto to_ms = [](std::chrono::nanoseconds value) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(value).count();
+    };
+    out << "task " << snapshot.task_id << " (" << snapshot.name << ") "
+        << StateName(snapshot.state) << ", submitted " << to_ms(snapshot.age) << "ms ago";
+    if (snapshot.worker) {
+        out << ", running " << to_ms(snapshot.running_for) << "ms on worker " << *snapshot.worker;
+    }
+    if (snapshot.time_trigger_in) {
+        out << ", time trigger in " << to_ms(*snapshot.time_trigger_in) << "ms";
+    }
+    if (!snapshot.unfinished_dependencies.empty()) {
+        out << ", waits for";
+        for (auto id : snapshot.unfinished_dependencies) {
+            out << ' ' << id;
+        }
+    }
+    return out;
+}
+
+// Only task pointers are copied under the queue, timer and worker slot locks, every
+// task is then inspected on its own, so workers never wait for the whole traversal.
+// Task locks are only tried, Snapshot never waits for a running task.
+std::vector<TaskSnapshot> Executor::Snapshot() const {
+    auto stats_now = StatsClock::now();
+    auto now = clock_();
+
+    struct Entry {
+        TaskSharedPtr task;
+        std::optional<size_t> worker;
+        StatsClock::time_point since;
+    };
+    std::vector<Entry> entries;
+    for (size_t i = 0; i < worker_slots_.size(); ++i) {
+        auto lock = std::scoped_lock{worker_slots_[i].mutex};
+        if (worker_slots_[i].task) {
+            entries.push_back({worker_slots_[i].task, i, worker_slots_[i].since});
+        }
+    }
+    scheduler_.ForEach([&](const TaskSharedPtr& task) {
+        if (task) {
+            entries.push_back({task, std::nullopt, {}});
+        }
+    });
+    {
+        auto lock = std::scoped_lock{timers_mutex_};
+        for (const auto& timer : timers_) {
+            entries.push_back({timer.task, std::nullopt, {}});
+        }
+    }
+
+    std::vector<TaskSnapshot> result;
+    std::unordered_set<uint64_t> seen;
+    result.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const auto& task = entry.task;
+        if (!seen.insert(task->GetId()).second) {
+            continue;
+        }
+        TaskSnapshot snapshot;
+        snapshot.task_id = task->GetId();
+        snapshot.name = task->GetName();
+        snapshot.age = std::chrono::nanoseconds(NanosecondsBetween(task->submitted_at_, stats_now));
+        auto state = task->state_.load();
+        if (state == TaskState::Running) {
+            snapshot.state = SnapshotState::Running;
+            if (entry.worker) {
+                snapshot.worker = entry.worker;
+                snapshot.thread = thread_pool_[*entry.worker].get_id();
+                snapshot.running_for =
+                    std::chrono::nanoseconds(NanosecondsBetween(entry.since, stats_now));
+            }
+            result.push_back(std::move(snapshot));
+            continue;
+        }
+        if (state != TaskState::Pending) {
+            continue;
+        }
+        // Execute holds the lock for the whole run, so it is only tried. The lock is also
+        // taken briefly on submit and cancel, a busy task is retried once, then reported
+        // with the state it has now and no details
+        auto lock = std::unique_lock{task->mutex_, std::try_to_lock};
+        if (!lock.owns_lock()) {
+            std::this_thread::yield();
+            lock.try_lock();
+        }
+        if (!lock.owns_lock()) {
+            if (task->state_.load() == TaskState::Running) {
+                snapshot.state = SnapshotState::Running;
+            }
+            snapshot.complete = false;
+            result.push_back(std::move(snapshot));
+            continue;
+        }
+        if (task->time_trigger_ != TimePoint::min()) {
+            snapshot.time_trigger = task->time_trigger_;
+            snapshot.time_trigger_in =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(task->time_trigger_ - now);
+        }
+        for (const auto& dependency : task->dependencies_) {
+            if (!dependency->IsFinished()) {
+                snapshot.unfinished_dependencies.push_back(dependency->GetId());
+            }
+        }
+        if (task->DependenciesSatisfied() && now >= task->time_trigger_) {
+            snapshot.state = SnapshotState::Ready;
+        }
+        result.push_back(std::move(snapshot));
+    }
+    return result;
+}
@@ -0,0 +1,30 @@
+#include "executors/stats.h"
+
+void WorkerStats::Load(const WorkerCounters& counters) noexcept {
+    executed = counters.executed.load(std::memory_order_relaxed);
+    failed = counters.failed.load(std::memory_order_relaxed);
+    canceled = counters.canceled.load(std::memory_order_relaxed);
+    requeued = counters.requeued.load(std::memory_order_relaxed);
+    parks = counters.parks.load(std::memory_order_relaxed);
+    unparks = counters.unparks.load(std::memory_order_relaxed);
+    timer_wakeups = counters.timer_wakeups.load(std::memory_order_relaxed);
+    busy_time = std::chrono::nanoseconds(counters.busy_ns.load(std::memory_order_relaxed));
+    idle_time = std::chrono::nanoseconds(counters.idle_ns.load(std::memory_order_relaxed));
+    cpu_time = std::chrono::nanoseconds(counters.cpu_ns.load(std::memory_order_relaxed));
+    spin_time = std::chrono::nanoseconds(counters.spin_ns.load(std::memory_order_relaxed));
+}
+
+WorkerStats& WorkerStats::operator+=(const WorkerStats& other) noexcept {
+    executed += other.executed;
+    failed += other.failed;
+    canceled += other.canceled;
+    requeued += other.requeued;
+    parks += other.parks;
+    unparks += other.unparks;
+    timer_wakeups += other.timer_wakeups;
+    busy_time += other.busy_time;
+    idle_time += other.idle_time;
+    cpu_time += other.cpu_time;
+    spin_time += other.spin_time;
+    return *this;
+}
@@ -0,0 +1,198 @@
+#include "executors/trace.h"
+#include "executors/profile.h"
+
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint64_t kThreadBits = 32;
+constexpr uint64_t kLabelBit = uint64_t{1} << 63;
+
+// JSON string escaping, control characters without a short form become \u00XX
+void WriteEscaped(std::ostream& out, const std::string& value) {
+    constexpr const char* kHex = "0123456789abcdef";
+    for (char c : value) {
+        auto byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c == '\n') {
+            out << "\\n";
+        } else if (c == '\t') {
+            out << "\\t";
+        } else if (byte < 0x20) {
+            out << "\\u00" << kHex[byte >> 4] << kHex[byte & 0xf];
+        } else {
+            out << c;
+        }
+    }
+}
+
+void WriteMicroseconds(std::ostream& out, uint64_t nanoseconds) {
+    auto fraction = std::to_string(nanoseconds % 1000);
+    out << nanoseconds / 1000 << '.' << std::string(3 - fraction.size(), '0') << fraction;
+}
+
+const char* EventName(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::Submit:
+            return "submit";
+        case TraceEventType::Ready:
+            return "ready";
+        case TraceEventType::Cancel:
+            return "cancel";
+        default:
+            return "task";
+    }
+}
+
+}  // namespace
+
+TraceRing::TraceRing(size_t capacity)
+    : slots_(new Slot[std::bit_ceil(std::max<size_t>(capacity, 2))]),
+      mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1) {
+}
+
+void TraceRing::Record(const TraceEvent& event) noexcept {
+    auto index = head_.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = slots_[index & mask_];
+    // A writer a whole lap behind drops its event instead of sharing the slot
+    auto sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+        if (sequence % 2 == 1 || sequence > 2 * index) {
+            return;
+        }
+    } while (!slot.sequence.compare_exchange_weak(sequence, 2 * index + 1,
+                                                  std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.type_and_thread.store((event.is_label ? kLabelBit : 0) |
+                                   static_cast<uint64_t>(event.type) << kThreadBits | event.thread,
+                               std::memory_order_relaxed);
+    slot.task_id.store(event.task_id, std::memory_order_relaxed);
+    slot.timestamp.store(event.timestamp, std::memory_order_relaxed);
+    slot.arg.store(event.arg, std::memory_order_relaxed);
+    slot.name.store(event.name, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void TraceRing::Collect(std::vector<TraceEvent>* events) const {
+    for (size_t i = 0; i <= mask_; ++i) {
+        const auto& slot = slots_[i];
+        auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence % 2 == 1) {
+            continue;
+        }
+        TraceEvent event;
+        auto type_and_thread = slot.type_and_thread.load(std::memory_order_relaxed);
+        event.is_label = type_and_thread & kLabelBit;
+        event.type = static_cast<TraceEventType>((type_and_thread & ~kLabelBit) >> kThreadBits);
+        event.thread = type_and_thread & ((uint64_t{1} << kThreadBits) - 1);
+        event.task_id = slot.task_id.load(std::memory_order_relaxed);
+        event.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+        event.arg = slot.arg.load(std::memory_order_relaxed);
+        event.name = slot.name.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        events->push_back(event);
+    }
+}
+
+Tracer::Tracer(size_t workers, size_t capacity) : origin_(StatsClock::now()), workers_(workers) {
+    if (capacity == 0) {
+        return;
+    }
+    for (size_t i = 0; i <= workers; ++i) {
+        rings_.push_back(std::make_unique<TraceRing>(capacity));
+    }
+}
+
+std::vector<TraceEvent> Tracer::Collect() const {
+    std::vector<TraceEvent> events;
+    for (const auto& ring : rings_) {
+        ring->Collect(&events);
+    }
+    std::sort(events.begin(), events.end(), [](const TraceEvent& lhs, const TraceEvent& rhs) {
+        return lhs.timestamp < rhs.timestamp;
+    });
+    return events;
+}
+
+void Tracer::WriteChromeTrace(std::ostream& out) const {
+    auto events = Collect();
+
+    std::unordered_map<uint64_t, const TraceEvent*> runs;
+    std::unordered_map<const char*, std::string> names;
+    for (const auto& event : events) {
+        if (event.type == TraceEventType::Run) {
+            runs[event.task_id] = &event;
+            if (!names.contains(event.name)) {
+                if (event.name == nullptr) {
+                    names[event.name] = "task";
+                } else {
+                    names[event.name] = event.is_label ? event.name : DemangleTypeName(event.name);
+                }
+            }
+        }
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto begin_event = [&](const char* phase, uint64_t thread, uint64_t timestamp) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << thread << ",\"ts\":";
+        WriteMicroseconds(out, timestamp);
+    };
+
+    for (size_t i = 0; i <= workers_ && IsEnabled(); ++i) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        out << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << i
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        if (i == workers_) {
+            out << "external";
+        } else {
+            out << "worker " << i;
+        }
+        out << "\"}}";
+    }
+
+    uint64_t flow_id = 0;
+    for (const auto& event : events) {
+        switch (event.type) {
+            case TraceEventType::Run:
+                begin_event("X", event.thread, event.timestamp);
+                out << ",\"dur\":";
+                WriteMicroseconds(out, event.arg);
+                out << ",\"cat\":\"task\",\"name\":\"";
+                WriteEscaped(out, names[event.name]);
+                out << "\",\"args\":{\"id\":" << event.task_id << "}}";
+                break;
+            case TraceEventType::Edge: {
+                auto dependency = runs.find(event.arg);
+                if (dependency == runs.end()) {
+                    break;
+                }
+                const auto& from = *dependency->second;
+                ++flow_id;
+                begin_event("s", from.thread, from.timestamp + from.arg);
+                out << ",\"cat\":\"dependency\",\"name\":\"dependency\",\"id\":" << flow_id
+                    << "}";
+                begin_event("f", event.thread, event.timestamp);
+                out << ",\"bp\":\"e\",\"cat\":\"dependency\",\"name\":\"dependency\",\"id\":"
+                    << flow_id << "}";
+                break;
+            }
+            default:
+                begin_event("i", event.thread, event.timestamp);
+                out << ",\"s\":\"t\",\"cat\":\"task\",\"name\":\"" << EventName(event.type)
+                    << "\",\"args\":{\"id\":" << event.task_id << "}}";
+                break;
+        }
+    }
+    out << "\n]}\n";
+}
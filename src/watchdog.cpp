@@ -0,0 +1,70 @@
+#include "executors/executors.h"
+
+#include <condition_variable>
+#include <iostream>
+
+std::ostream& operator<<(std::ostream& out, const StallReport& report) {
+    auto age_ms = std::chrono::duration_cast<std::chrono::milliseconds>(report.age).count();
+    out << "executors watchdog: task " << report.task_id << " (" << report.name << ")";
+    if (report.kind == StallReport::Kind::LongRunning) {
+        out << " is running for " << age_ms << "ms on worker " << report.worker << " (thread "
+            << report.thread << ")";
+    } else {
+        out << " is not ready " << age_ms << "ms after submit, "
+            << report.unfinished_dependencies << " unfinished dependencies";
+    }
+    return out;
+}
+
+void Executor::WatchdogLoop(std::stop_token stop) {
+    std::mutex mutex;
+    std::condition_variable_any wakeup;
+    std::unordered_set<uint64_t> reported;
+    auto lock = std::unique_lock{mutex};
+    while (true) {
+        wakeup.wait_for(lock, stop, watchdog_options_.period, [] { return false; });
+        if (stop.stop_requested()) {
+            return;
+        }
+        CheckStalls(&reported);
+    }
+}
+
+void Executor::CheckStalls(std::unordered_set<uint64_t>* reported) {
+    auto now = clock_();
+    std::unordered_set<uint64_t> stalled;
+    for (auto& task : Snapshot()) {
+        StallReport report;
+        if (task.state == SnapshotState::Running && task.worker &&
+            task.running_for >= watchdog_options_.running_threshold) {
+            report.kind = StallReport::Kind::LongRunning;
+            report.age = task.running_for;
+            report.worker = *task.worker;
+            report.thread = task.thread;
+        } else if (task.state == SnapshotState::Pending && task.complete &&
+                   task.age >= watchdog_options_.pending_threshold) {
+            bool waits_for_timer = task.unfinished_dependencies.empty() && task.time_trigger &&
+                                   *task.time_trigger > now;
+            if (waits_for_timer) {
+                continue;
+            }
+            report.kind = StallReport::Kind::NeverReady;
+            report.age = task.age;
+            report.unfinished_dependencies = task.unfinished_dependencies.size();
+        } else {
+            continue;
+        }
+        report.task_id = task.task_id;
+        report.name = std::move(task.name);
+
+        if (!stalled.insert(report.task_id).second || reported->contains(report.task_id)) {
+            continue;
+        }
+        if (watchdog_options_.on_stall) {
+            watchdog_options_.on_stall(report);
+        } else {
+            std::cerr << report << std::endl;
+        }
+    }
+    *reported = std::move(stalled);
+}
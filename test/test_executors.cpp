@@ -388,3 +388,307 @@ INSTANTIATE_TEST_CASE_P(ThreadPool, ExecutorsTest,
                         ::testing::Values([] { return MakeThreadPoolExecutor(1); },
                                           [] { return MakeThreadPoolExecutor(2); },
                                           [] { return MakeThreadPoolExecutor(10); }));
+
+TEST(ClockTest, CoarseClockSharesEpoch) {
+    auto coarse = CoarseClockNow();
+    auto precise = Clock::now();
+    EXPECT_LE(coarse, precise);
+    EXPECT_LT(precise - coarse, std::chrono::milliseconds(100));
+}
+
+TEST(ClockTest, SystemTimeTrigger) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(std::chrono::system_clock::now() + std::chrono::milliseconds(50));
+    auto start = Clock::now();
+    pool->Submit(task);
+    task->Wait();
+    EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(40));
+}
+
+namespace {
+
+std::atomic<int64_t> test_clock_offset_hours{0};
+
+TimePoint TestClockNow() {
+    return Clock::now() + std::chrono::hours(test_clock_offset_hours.load());
+}
+
+}  // namespace
+
+TEST(ClockTest, InjectedClock) {
+    auto pool = MakeThreadPoolExecutor(1, ExecutorOptions{.clock = &TestClockNow});
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(Clock::now() + std::chrono::hours(1));
+    pool->Submit(task);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(task->IsFinished());
+
+    test_clock_offset_hours = 2;
+    task->Wait();
+    EXPECT_TRUE(task->completed);
+    test_clock_offset_hours = 0;
+}
+
+TEST(TimerTest, IdleWorkersSleepUntilDeadline) {
+    auto pool = MakeThreadPoolExecutor(2);
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(Clock::now() + std::chrono::milliseconds(200));
+    pool->Submit(task);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto stats = pool->GetStats();
+    EXPECT_EQ(stats.pending_timers, 1u);
+    EXPECT_LE(stats.total.requeued, 1u);
+    EXPECT_LT(stats.total.busy_time, std::chrono::milliseconds(10));
+
+    task->Wait();
+    EXPECT_TRUE(task->completed);
+    EXPECT_EQ(pool->GetStats().pending_timers, 0u);
+}
+
+TEST(TimerTest, OneIdleWorkerWaitsForTimers) {
+    auto pool = MakeThreadPoolExecutor(4);
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(Clock::now() + std::chrono::milliseconds(100));
+    pool->Submit(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    auto unparks = pool->GetStats().total.unparks;
+    task->Wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // The timer waiter and at most one worker taking over its role wake up
+    EXPECT_LE(pool->GetStats().total.unparks - unparks, 3u);
+}
+
+TEST(TimerTest, EarlierTimerWakesSleepingWorker) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto late = std::make_shared<TestTask>();
+    auto early = std::make_shared<TestTask>();
+    late->SetTimeTrigger(Clock::now() + std::chrono::seconds(10));
+    pool->Submit(late);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto start = Clock::now();
+    early->SetTimeTrigger(start + std::chrono::milliseconds(20));
+    pool->Submit(early);
+    early->Wait();
+    EXPECT_LT(Clock::now() - start, std::chrono::seconds(1));
+    EXPECT_FALSE(late->IsFinished());
+    late->Cancel();
+}
+
+TEST(TimerTest, CoalescesOverlappingSlackWindows) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto start = Clock::now() + std::chrono::milliseconds(50);
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 100; ++i) {
+        auto task = std::make_shared<TestTask>();
+        task->SetTimeTrigger(start + std::chrono::microseconds(10 * i), std::chrono::milliseconds(2));
+        pool->Submit(task);
+        tasks.push_back(task);
+    }
+    for (auto& task : tasks) {
+        task->Wait();
+        EXPECT_TRUE(task->completed);
+    }
+    EXPECT_GE(Clock::now(), start + std::chrono::microseconds(990));
+    EXPECT_LE(pool->GetStats().total.timer_wakeups, 3u);
+}
+
+TEST(TimerTest, SlackNearMaxDeadlineDoesNotFire) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(TimePoint::max() - std::chrono::nanoseconds(1),
+                         std::chrono::milliseconds(1));
+    pool->Submit(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    EXPECT_FALSE(task->completed);
+    task->Cancel();
+}
+
+TEST(TimerTest, PreciseTriggerSpinsWithinMargin) {
+    class StartTask : public Task {
+    public:
+        TimePoint started_at;
+
+        void Run() override {
+            started_at = Clock::now();
+        }
+    };
+
+    auto margin = std::chrono::milliseconds(20);
+    auto pool = MakeThreadPoolExecutor(1, ExecutorOptions{.spin_margin = margin});
+    auto task = std::make_shared<StartTask>();
+    auto at = Clock::now() + std::chrono::milliseconds(50);
+    task->SetPreciseTimeTrigger(at);
+    pool->Submit(task);
+    task->Wait();
+
+    EXPECT_TRUE(task->IsCompleted());
+    EXPECT_GE(task->started_at, at);
+    EXPECT_LT(task->started_at - at, margin);
+    // The spin is bounded by the margin, but preemption can stretch it on a loaded machine
+    auto spin_time = pool->GetStats().total.spin_time;
+    EXPECT_GT(spin_time, std::chrono::nanoseconds{0});
+    EXPECT_LT(spin_time, margin + std::chrono::milliseconds(50));
+}
+
+TEST(PeriodicTest, FixedRateReusesTask) {
+    auto pool = MakeThreadPoolExecutor(2);
+    std::atomic<int> runs = 0;
+    auto start = Clock::now();
+    auto task = pool->SchedulePeriodic([&runs] { ++runs; }, std::chrono::milliseconds(5));
+
+    while (task->GetRuns() < 5) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_GE(Clock::now() - start, std::chrono::milliseconds(25));
+    task->Cancel();
+    task->Wait();
+    EXPECT_TRUE(task->IsCanceled());
+    auto final_runs = runs.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(runs.load(), final_runs);
+    EXPECT_EQ(task->GetRuns(), static_cast<uint64_t>(final_runs));
+    auto stats = pool->GetStats();
+    EXPECT_EQ(stats.submitted, 1u);
+    EXPECT_EQ(stats.total.executed, static_cast<uint64_t>(final_runs));
+}
+
+TEST(PeriodicTest, CancelWhileRunning) {
+    auto pool = MakeThreadPoolExecutor(1);
+    std::shared_ptr<PeriodicTask> task;
+    std::atomic<bool> ready = false;
+    task = pool->SchedulePeriodic(
+        [&] {
+            while (!ready) {
+                std::this_thread::yield();
+            }
+            task->Cancel();
+        },
+        std::chrono::milliseconds(1));
+    ready = true;
+    task->Wait();
+    EXPECT_TRUE(task->IsCanceled());
+    EXPECT_EQ(task->GetRuns(), 1u);
+}
+
+TEST(PeriodicTest, FixedDelayWaitsAfterRun) {
+    auto pool = MakeThreadPoolExecutor(1);
+    std::vector<TimePoint> starts;
+    std::mutex mutex;
+    auto task = pool->SchedulePeriodic(
+        [&] {
+            auto lock = std::scoped_lock{mutex};
+            starts.push_back(Clock::now());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        },
+        std::chrono::milliseconds(10), PeriodicOptions{.mode = PeriodicMode::FixedDelay});
+    while (task->GetRuns() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    task->Cancel();
+
+    auto lock = std::scoped_lock{mutex};
+    for (size_t i = 1; i < 3; ++i) {
+        EXPECT_GE(starts[i] - starts[i - 1], std::chrono::milliseconds(20));
+    }
+}
+
+TEST(PeriodicTest, MissedTickPolicies) {
+    auto run = [](MissedTickPolicy policy) {
+        auto pool = MakeThreadPoolExecutor(1);
+        auto start = Clock::now();
+        std::atomic<int> runs = 0;
+        auto task = pool->SchedulePeriodic(
+            [&runs] {
+                if (runs++ == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(55));
+                }
+            },
+            std::chrono::milliseconds(10),
+            PeriodicOptions{.missed_ticks = policy, .start = start});
+        while (task->GetRuns() < 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        task->Cancel();
+        task->Wait();
+        return task;
+    };
+
+    // The first run covers ticks 0..5, ticks 10ms..50ms pass while it sleeps
+    auto skip = run(MissedTickPolicy::Skip);
+    EXPECT_GE(skip->GetMissedTicks(), 5u);
+    auto coalesce = run(MissedTickPolicy::Coalesce);
+    EXPECT_GE(coalesce->GetMissedTicks(), 4u);
+    auto catch_up = run(MissedTickPolicy::CatchUp);
+    EXPECT_EQ(catch_up->GetMissedTicks(), 0u);
+}
+
+TEST(PeriodicTest, RejectsNonPositivePeriod) {
+    auto pool = MakeThreadPoolExecutor(1);
+    EXPECT_THROW(pool->SchedulePeriodic([] {}, std::chrono::nanoseconds(0)),
+                 std::invalid_argument);
+}
+
+TEST(PeriodicTest, ShutdownCancelsArmedTask) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto periodic = pool->SchedulePeriodic([] {}, std::chrono::milliseconds(1));
+    auto timer = std::make_shared<TestTask>();
+    timer->SetTimeTrigger(Clock::now() + std::chrono::hours(1));
+    pool->Submit(timer);
+    while (periodic->GetRuns() < 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    pool->StartShutdown();
+    pool->WaitShutdown();
+    periodic->Wait();
+    timer->Wait();
+    EXPECT_TRUE(periodic->IsCanceled());
+    EXPECT_TRUE(timer->IsCanceled());
+    EXPECT_EQ(pool->GetStats().pending_timers, 0u);
+}
+
+TEST(PeriodicTest, CanceledTaskLeavesTimers) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto periodic = pool->SchedulePeriodic([] {}, std::chrono::hours(1));
+    std::weak_ptr<PeriodicTask> weak = periodic;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(pool->GetStats().pending_timers, 1u);
+
+    periodic->Cancel();
+    periodic.reset();
+    EXPECT_EQ(pool->GetStats().pending_timers, 0u);
+
+    // Any timer activity prunes the heap, well before the hour is up
+    auto task = std::make_shared<TestTask>();
+    task->SetTimeTrigger(Clock::now() + std::chrono::milliseconds(5));
+    pool->Submit(task);
+    task->Wait();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_TRUE(weak.expired());
+}
+
+TEST(PeriodicTest, ThrowingRunEndsSeries) {
+    auto pool = MakeThreadPoolExecutor(1);
+    std::atomic<int> runs = 0;
+    auto task = pool->SchedulePeriodic(
+        [&runs] {
+            if (++runs == 2) {
+                throw std::runtime_error("flush failed");
+            }
+        },
+        std::chrono::milliseconds(2));
+    task->Wait();
+
+    EXPECT_TRUE(task->IsFailed());
+    EXPECT_THROW(std::rethrow_exception(task->GetError()), std::runtime_error);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(runs.load(), 2);
+    EXPECT_EQ(pool->GetStats().pending_timers, 0u);
+    EXPECT_EQ(pool->GetStats().total.failed, 1u);
+}
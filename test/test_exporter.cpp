@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "executors/executors.h"
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() /
+            (name + "." + std::to_string(::getpid())))
+        .string();
+}
+
+std::string Scrape(const std::string& path, const std::string& request) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        ::close(fd);
+        return {};
+    }
+    ::send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, received);
+    }
+    ::close(fd);
+    return response;
+}
+
+}  // namespace
+
+TEST(ExporterTest, FormatsPrometheusText) {
+    ExecutorStats stats;
+    stats.submitted = 7;
+    stats.queue_depth = 3;
+    stats.workers.resize(2);
+    stats.workers[1].busy_time = std::chrono::milliseconds(1500);
+
+    auto text = FormatPrometheus(stats, "pool \"a\"");
+
+    EXPECT_NE(text.find("# TYPE executor_tasks_submitted_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("executor_tasks_submitted_total{executor=\"pool \\\"a\\\"\"} 7\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("executor_queue_depth{executor=\"pool \\\"a\\\"\"} 3\n"),
+              std::string::npos);
+    EXPECT_NE(
+        text.find("executor_worker_busy_seconds_total{executor=\"pool \\\"a\\\"\",worker=\"1\"} "
+                  "1.5\n"),
+        std::string::npos);
+}
+
+TEST(ExporterTest, ServesUnixSocket) {
+    auto path = TempPath("executors_exporter.sock");
+    ExecutorOptions options;
+    options.name = "socket_pool";
+    options.exporter.socket_path = path;
+    auto pool = MakeThreadPoolExecutor(2, options);
+    pool->Invoke<int>([] { return 1; })->Get();
+    while (pool->GetStats().total.executed == 0) {
+        std::this_thread::yield();
+    }
+
+    auto plain = Scrape(path, "");
+    EXPECT_NE(plain.find("executor_tasks_executed_total{executor=\"socket_pool\"} 1\n"),
+              std::string::npos);
+
+    auto http = Scrape(path, "GET /metrics HTTP/1.0\r\n\r\n");
+    EXPECT_EQ(http.find("HTTP/1.0 200 OK\r\n"), 0u);
+    EXPECT_NE(http.find("executor_tasks_submitted_total{executor=\"socket_pool\"} 1\n"),
+              std::string::npos);
+
+    pool.reset();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(ExporterTest, WritesFile) {
+    auto path = TempPath("executors_exporter.prom");
+    ExecutorOptions options;
+    options.name = "file_pool";
+    options.exporter.file_path = path;
+    options.exporter.interval = std::chrono::milliseconds(10);
+    auto pool = MakeThreadPoolExecutor(1, options);
+    pool->Invoke<int>([] { return 1; })->Get();
+    pool.reset();
+
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    EXPECT_NE(text.str().find("executor_tasks_executed_total{executor=\"file_pool\"} 1\n"),
+              std::string::npos);
+    std::filesystem::remove(path);
+}
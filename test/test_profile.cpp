@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <ctime>
+#include <sstream>
+#include <thread>
+
+#include "executors/executors.h"
+
+class ProfiledTask : public Task {
+public:
+    void Run() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+};
+
+class ProfiledFailingTask : public Task {
+public:
+    void Run() override {
+        throw std::runtime_error("Failed");
+    }
+};
+
+TEST(ProfileTest, EmptyWhenDisabled) {
+    auto pool = MakeThreadPoolExecutor(1);
+    pool->Invoke<int>([] { return 1; })->Get();
+
+    EXPECT_TRUE(pool->GetProfile().empty());
+}
+
+TEST(ProfileTest, GroupsByTypeAndLabel) {
+    auto pool = MakeThreadPoolExecutor(2, ExecutorOptions{.profile_tasks = true});
+
+    std::vector<TaskSharedPtr> tasks;
+    for (int i = 0; i < 3; ++i) {
+        tasks.push_back(std::make_shared<ProfiledTask>());
+    }
+    tasks.push_back(std::make_shared<ProfiledFailingTask>());
+    for (const auto& task : tasks) {
+        pool->Submit(task);
+    }
+    auto future = pool->Invoke<int>([] { return 42; }, "answer");
+    future->Get();
+    for (const auto& task : tasks) {
+        task->Wait();
+    }
+    auto canceled = std::make_shared<ProfiledTask>();
+    auto blocker = std::make_shared<ProfiledTask>();
+    canceled->AddDependency(blocker);
+    pool->Submit(canceled);
+    canceled->Cancel();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto profile = pool->GetProfile();
+    ASSERT_GE(profile.size(), 3u);
+    EXPECT_EQ(profile[0].name, "ProfiledTask");
+    EXPECT_EQ(profile[0].count, 3u);
+    EXPECT_GE(profile[0].total_time, std::chrono::milliseconds(6));
+    EXPECT_GE(profile[0].max_time, profile[0].mean_time);
+    EXPECT_EQ(profile[0].cancellations, 1u);
+
+    auto find = [&](const std::string& name) {
+        for (const auto& entry : profile) {
+            if (entry.name == name) {
+                return entry;
+            }
+        }
+        return TaskTypeProfile{};
+    };
+    EXPECT_EQ(find("answer").count, 1u);
+    EXPECT_EQ(find("ProfiledFailingTask").failures, 1u);
+
+    std::stringstream out;
+    pool->DumpProfile(out);
+    EXPECT_NE(out.str().find("ProfiledTask"), std::string::npos);
+    EXPECT_LT(out.str().find("ProfiledTask"), out.str().find("answer"));
+}
+
+TEST(ProfileTest, MeasuresCpuTime) {
+    ExecutorOptions options;
+    options.profile_tasks = true;
+    options.measure_cpu_time = true;
+    auto pool = MakeThreadPoolExecutor(1, options);
+
+    pool->Invoke<Unit>(
+            [] {
+                // Spins for 20ms of CPU time, wall time would depend on the load
+                auto cpu_ns = [] {
+                    timespec now{};
+                    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+                    return now.tv_sec * 1'000'000'000 + now.tv_nsec;
+                };
+                auto until = cpu_ns() + 20'000'000;
+                while (cpu_ns() < until) {
+                }
+                return Unit{};
+            },
+            "spin")
+        ->Get();
+    pool->Invoke<Unit>(
+            [] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                return Unit{};
+            },
+            "sleep")
+        ->Get();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto profile = pool->GetProfile();
+    ASSERT_EQ(profile.size(), 2u);
+    auto spin = profile[0].name == "spin" ? profile[0] : profile[1];
+    auto sleep = profile[0].name == "spin" ? profile[1] : profile[0];
+    ASSERT_EQ(spin.name, "spin");
+    ASSERT_EQ(sleep.name, "sleep");
+    EXPECT_GE(spin.cpu_time, std::chrono::milliseconds(10));
+    EXPECT_LT(sleep.cpu_time, spin.cpu_time);
+
+    auto stats = pool->GetStats();
+    EXPECT_EQ(stats.total.cpu_time, profile[0].cpu_time + profile[1].cpu_time);
+}
+
+TEST(ProfileTest, CpuTimeIsOptIn) {
+    auto pool = MakeThreadPoolExecutor(1);
+    pool->Invoke<int>([] { return 1; })->Get();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    EXPECT_EQ(pool->GetStats().total.cpu_time.count(), 0);
+}
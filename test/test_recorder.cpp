@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "executors/executors.h"
+
+class RecordedTestTask : public Task {
+public:
+    void Run() override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+};
+
+TEST(RecorderTest, GraphRoundTrip) {
+    RecordedGraph graph(3);
+    graph[1].submitted_at = std::chrono::microseconds(5);
+    graph[1].executed = true;
+    graph[1].run_time = std::chrono::nanoseconds(1234567);
+    graph[1].dependencies = {0, 2};
+    graph[2].submitted_at = std::chrono::microseconds(3);
+    graph[2].time_trigger = std::chrono::milliseconds(-7);
+    graph[2].triggers = {0};
+
+    std::stringstream buffer;
+    WriteGraph(buffer, graph);
+    auto read = ReadGraph(buffer);
+
+    ASSERT_EQ(read.size(), 3u);
+    EXPECT_FALSE(read[0].executed);
+    EXPECT_EQ(read[1].submitted_at, std::chrono::microseconds(5));
+    EXPECT_TRUE(read[1].executed);
+    EXPECT_EQ(read[1].run_time, std::chrono::nanoseconds(1234567));
+    EXPECT_EQ(read[1].dependencies, (std::vector<size_t>{0, 2}));
+    EXPECT_EQ(read[2].submitted_at, std::chrono::microseconds(3));
+    EXPECT_EQ(read[2].time_trigger, std::chrono::milliseconds(-7));
+    EXPECT_EQ(read[2].triggers, (std::vector<size_t>{0}));
+}
+
+TEST(RecorderTest, RejectsGarbage) {
+    std::stringstream garbage("not a graph");
+    EXPECT_THROW(ReadGraph(garbage), std::runtime_error);
+
+    std::stringstream buffer;
+    WriteGraph(buffer, RecordedGraph(2));
+    auto truncated = buffer.str();
+    truncated.pop_back();
+    std::stringstream truncated_buffer(truncated);
+    EXPECT_THROW(ReadGraph(truncated_buffer), std::runtime_error);
+}
+
+TEST(RecorderTest, RecordsExecutorGraph) {
+    auto pool = MakeThreadPoolExecutor(2, ExecutorOptions{.record_graph = true});
+
+    auto first = std::make_shared<RecordedTestTask>();
+    auto second = std::make_shared<RecordedTestTask>();
+    auto timer = std::make_shared<RecordedTestTask>();
+    auto never_submitted = std::make_shared<RecordedTestTask>();
+    second->AddDependency(first);
+    timer->AddTrigger(second);
+    timer->AddTrigger(never_submitted);
+    timer->SetTimeTrigger(Clock::now() + std::chrono::milliseconds(20));
+
+    pool->Submit(first);
+    pool->Submit(second);
+    pool->Submit(timer);
+    timer->Wait();
+    // Run times are recorded after waiters are woken
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    std::stringstream buffer;
+    pool->DumpGraph(buffer);
+    auto graph = ReadGraph(buffer);
+
+    ASSERT_EQ(graph.size(), 3u);
+    for (const auto& task : graph) {
+        EXPECT_TRUE(task.executed);
+        EXPECT_GE(task.run_time, std::chrono::milliseconds(2));
+    }
+    EXPECT_EQ(graph[1].dependencies, (std::vector<size_t>{0}));
+    EXPECT_EQ(graph[2].triggers, (std::vector<size_t>{1}));
+    ASSERT_TRUE(graph[2].time_trigger);
+    EXPECT_GT(*graph[2].time_trigger, std::chrono::milliseconds(10));
+    EXPECT_LE(graph[0].submitted_at, graph[2].submitted_at);
+}
+
+TEST(RecorderTest, ClearDropsRecordedTasks) {
+    GraphRecorder recorder(true);
+    auto start = StatsClock::now();
+    recorder.RecordSubmit(1, start, std::nullopt, {}, {});
+    recorder.RecordSubmit(2, start, std::nullopt, {1}, {});
+    recorder.Clear();
+    EXPECT_TRUE(recorder.Collect().empty());
+
+    recorder.RecordRun(2, std::chrono::milliseconds(1));
+    recorder.RecordSubmit(3, start + std::chrono::milliseconds(5), std::nullopt, {1}, {});
+    auto graph = recorder.Collect();
+    ASSERT_EQ(graph.size(), 1u);
+    EXPECT_EQ(graph[0].submitted_at, std::chrono::nanoseconds{0});
+    EXPECT_TRUE(graph[0].dependencies.empty());
+    EXPECT_FALSE(graph[0].executed);
+}
+
+TEST(RecorderTest, RejectsOversizedCounts) {
+    auto header = [] {
+        std::string data = "EXGR";
+        data.push_back(1);
+        return data;
+    };
+    // Varint task count close to 2^63 followed by nothing
+    auto huge_tasks = header() + std::string(8, '\xff') + '\x7f';
+    std::stringstream huge_tasks_buffer(huge_tasks);
+    EXPECT_THROW(ReadGraph(huge_tasks_buffer), std::runtime_error);
+
+    // One task, flags 0, claiming 2^62 dependencies
+    auto huge_edges = header() + '\x01' + '\x00' + '\x00' + std::string(8, '\xff') + '\x3f';
+    std::stringstream huge_edges_buffer(huge_edges);
+    EXPECT_THROW(ReadGraph(huge_edges_buffer), std::runtime_error);
+
+    // One task with two dependencies
+    auto extra_edges = header() + '\x01' + '\x00' + '\x00' + '\x02' + '\x00' + '\x00';
+    std::stringstream extra_edges_buffer(extra_edges);
+    EXPECT_THROW(ReadGraph(extra_edges_buffer), std::runtime_error);
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "executors/simulated.h"
+
+namespace {
+
+class OrderTask : public Task {
+public:
+    OrderTask(int index, std::vector<int>* order) : index_(index), order_(order) {
+    }
+
+    void Run() override {
+        order_->push_back(index_);
+    }
+
+private:
+    int index_;
+    std::vector<int>* order_;
+};
+
+std::vector<int> RunIndependentTasks(uint64_t seed) {
+    SimulatedExecutor executor(seed);
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        executor.Submit(std::make_shared<OrderTask>(i, &order));
+    }
+    EXPECT_EQ(executor.RunUntilIdle(), 100u);
+    return order;
+}
+
+}  // namespace
+
+TEST(SimulatedExecutorTest, SeedDeterminesOrder) {
+    auto first = RunIndependentTasks(1);
+    EXPECT_EQ(first, RunIndependentTasks(1));
+    EXPECT_NE(first, RunIndependentTasks(2));
+}
+
+TEST(SimulatedExecutorTest, RespectsDependencies) {
+    SimulatedExecutor executor(7);
+    std::vector<int> order;
+    std::vector<TaskSharedPtr> chain;
+    for (int i = 0; i < 50; ++i) {
+        chain.push_back(std::make_shared<OrderTask>(i, &order));
+        if (i > 0) {
+            chain[i]->AddDependency(chain[i - 1]);
+        }
+    }
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        executor.Submit(*it);
+    }
+    executor.RunUntilIdle();
+
+    ASSERT_EQ(order.size(), 50u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(SimulatedExecutorTest, VirtualTimeSkipsAhead) {
+    SimulatedExecutor executor(3);
+    auto start = executor.Now();
+    std::vector<int> order;
+    auto late = std::make_shared<OrderTask>(1, &order);
+    auto early = std::make_shared<OrderTask>(0, &order);
+    late->SetTimeTrigger(start + std::chrono::hours(2));
+    early->SetTimeTrigger(start + std::chrono::hours(1));
+    executor.Submit(late);
+    executor.Submit(early);
+
+    auto real_start = std::chrono::steady_clock::now();
+    EXPECT_EQ(executor.RunUntil(start + std::chrono::minutes(90)), 1u);
+    EXPECT_EQ(order, std::vector<int>{0});
+    EXPECT_EQ(executor.Now(), start + std::chrono::minutes(90));
+
+    EXPECT_EQ(executor.RunUntilIdle(), 1u);
+    EXPECT_EQ(order, (std::vector<int>{0, 1}));
+    EXPECT_EQ(executor.Now(), start + std::chrono::hours(2));
+    EXPECT_LT(std::chrono::steady_clock::now() - real_start, std::chrono::seconds(1));
+}
+
+TEST(SimulatedExecutorTest, Combinators) {
+    SimulatedExecutor executor(11);
+    auto fast = executor.Invoke<int>([] { return 1; });
+    std::vector<int> order;
+    auto gate = std::make_shared<OrderTask>(0, &order);
+    gate->SetTimeTrigger(executor.Now() + std::chrono::seconds(10));
+    executor.Submit(gate);
+    auto slow = executor.Then<int>(fast, [] { return 2; });
+    slow->AddDependency(gate);
+    auto deadline = executor.WhenAllBeforeDeadline(std::vector<FuturePtr<int>>{fast, slow},
+                                                   executor.Now() + std::chrono::seconds(5));
+    auto all = executor.WhenAll(std::vector<FuturePtr<int>>{fast, slow});
+
+    executor.RunUntilIdle();
+
+    EXPECT_EQ(deadline->Get(), std::vector<int>{1});
+    EXPECT_EQ(all->Get(), (std::vector<int>{1, 2}));
+}
+
+TEST(SimulatedExecutorTest, SubmitFromTask) {
+    SimulatedExecutor executor(5);
+    int remaining = 10000;
+    std::function<void()> spawn = [&] {
+        if (--remaining > 0) {
+            executor.Invoke<Unit>([&] {
+                spawn();
+                return Unit{};
+            });
+        }
+    };
+    spawn();
+    EXPECT_EQ(executor.RunUntilIdle(), 9999u);
+    EXPECT_EQ(remaining, 0);
+}
+
+TEST(SimulatedExecutorTest, CancelsPendingTasksOnDestruction) {
+    auto blocker = std::make_shared<OrderTask>(0, nullptr);
+    auto task = std::make_shared<OrderTask>(1, nullptr);
+    task->AddDependency(blocker);
+    {
+        SimulatedExecutor executor(1);
+        executor.Submit(task);
+        EXPECT_EQ(executor.RunUntilIdle(), 0u);
+    }
+    EXPECT_TRUE(task->IsCanceled());
+}
+
+TEST(SimulatedExecutorTest, RearmsPeriodicTasksInVirtualTime) {
+    auto start = Clock::now();
+    SimulatedExecutor executor(1, start);
+    std::vector<TimePoint> runs;
+    std::vector<int> order;
+    auto task = executor.SchedulePeriodic([&] { runs.push_back(executor.Now()); },
+                                          std::chrono::milliseconds(10));
+    auto delayed = executor.SchedulePeriodic([] {}, std::chrono::milliseconds(20),
+                                             PeriodicOptions{.mode = PeriodicMode::FixedDelay});
+
+    EXPECT_EQ(executor.RunUntil(start + std::chrono::milliseconds(55)), 7u);
+    ASSERT_EQ(runs.size(), 5u);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        EXPECT_EQ(runs[i], start + std::chrono::milliseconds(10) * (i + 1));
+    }
+    EXPECT_EQ(delayed->GetRuns(), 2u);
+
+    // Only periodic tasks are armed, RunUntilIdle stops instead of ticking forever
+    EXPECT_EQ(executor.RunUntilIdle(), 0u);
+    auto timer = std::make_shared<OrderTask>(0, &order);
+    timer->SetTimeTrigger(start + std::chrono::milliseconds(75));
+    executor.Submit(timer);
+    EXPECT_EQ(executor.RunUntilIdle(), 4u);
+    EXPECT_TRUE(timer->IsCompleted());
+    EXPECT_EQ(runs.size(), 7u);
+
+    task->Cancel();
+    delayed->Cancel();
+    EXPECT_EQ(executor.RunUntilIdle(), 0u);
+    EXPECT_TRUE(task->IsCanceled());
+    EXPECT_EQ(task->GetRuns(), 7u);
+}
+
+TEST(SimulatedExecutorTest, PeriodicTickDueNowIsNotMissed) {
+    auto start = Clock::now();
+    SimulatedExecutor executor(1, start);
+    std::vector<int> order;
+    auto blocker = std::make_shared<OrderTask>(0, &order);
+    blocker->SetTimeTrigger(start + std::chrono::milliseconds(20));
+    executor.Submit(blocker);
+
+    // The first tick at 10ms waits for blocker, so it runs at 20ms, which is the next tick
+    auto periodic = executor.SchedulePeriodic([] {}, std::chrono::milliseconds(10));
+    periodic->AddDependency(blocker);
+
+    executor.RunUntil(start + std::chrono::milliseconds(25));
+    EXPECT_EQ(periodic->GetRuns(), 2u);
+    EXPECT_EQ(periodic->GetMissedTicks(), 0u);
+    periodic->Cancel();
+}
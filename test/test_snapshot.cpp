@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "executors/executors.h"
+
+class BlockingTask : public Task {
+public:
+    void Run() override {
+        started = true;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+};
+
+class SnapshotTask : public Task {
+public:
+    void Run() override {
+    }
+};
+
+TEST(SnapshotTest, EmptyPool) {
+    auto pool = MakeThreadPoolExecutor(2);
+    EXPECT_TRUE(pool->Snapshot().empty());
+}
+
+TEST(SnapshotTest, ReportsRunningPendingAndReadyTasks) {
+    auto pool = MakeThreadPoolExecutor(1);
+
+    auto running = std::make_shared<BlockingTask>();
+    running->SetLabel("running");
+    pool->Submit(running);
+    while (!running->started) {
+        std::this_thread::yield();
+    }
+
+    auto ready = std::make_shared<SnapshotTask>();
+    ready->SetLabel("ready");
+    auto dependency = std::make_shared<SnapshotTask>();
+    auto pending = std::make_shared<SnapshotTask>();
+    pending->SetLabel("pending");
+    pending->AddDependency(dependency);
+    auto timer = std::make_shared<SnapshotTask>();
+    timer->SetTimeTrigger(std::chrono::system_clock::now() + std::chrono::hours(1));
+
+    pool->Submit(ready);
+    pool->Submit(pending);
+    pool->Submit(timer);
+
+    auto snapshot = pool->Snapshot();
+    ASSERT_EQ(snapshot.size(), 4u);
+
+    auto find = [&](uint64_t id) {
+        for (const auto& task : snapshot) {
+            if (task.task_id == id) {
+                return task;
+            }
+        }
+        ADD_FAILURE() << "task " << id << " is missing";
+        return TaskSnapshot{};
+    };
+
+    auto running_snapshot = find(running->GetId());
+    EXPECT_EQ(running_snapshot.state, SnapshotState::Running);
+    EXPECT_EQ(running_snapshot.name, "running");
+    EXPECT_EQ(running_snapshot.worker, 0u);
+
+    EXPECT_EQ(find(ready->GetId()).state, SnapshotState::Ready);
+
+    auto pending_snapshot = find(pending->GetId());
+    EXPECT_EQ(pending_snapshot.state, SnapshotState::Pending);
+    EXPECT_EQ(pending_snapshot.unfinished_dependencies,
+              std::vector<uint64_t>{dependency->GetId()});
+
+    auto timer_snapshot = find(timer->GetId());
+    EXPECT_EQ(timer_snapshot.state, SnapshotState::Pending);
+    EXPECT_EQ(timer_snapshot.name, "SnapshotTask");
+    EXPECT_TRUE(timer_snapshot.time_trigger.has_value());
+    ASSERT_TRUE(timer_snapshot.time_trigger_in.has_value());
+    EXPECT_GT(*timer_snapshot.time_trigger_in, std::chrono::minutes(59));
+    EXPECT_LE(*timer_snapshot.time_trigger_in, std::chrono::hours(1));
+
+    std::stringstream out;
+    out << running_snapshot;
+    EXPECT_NE(out.str().find("running"), std::string::npos);
+    out << timer_snapshot;
+    EXPECT_NE(out.str().find("time trigger in 35"), std::string::npos);
+
+    running->release = true;
+    timer->Cancel();
+    dependency->Cancel();
+    pending->Wait();
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "executors/executors.h"
+
+class CountedTask : public Task {
+public:
+    void Run() override {
+    }
+};
+
+class ThrowingTask : public Task {
+public:
+    void Run() override {
+        throw std::runtime_error("Failed");
+    }
+};
+
+TEST(ExecutorStatsTest, CountsExecutedAndFailedTasks) {
+    auto pool = MakeThreadPoolExecutor(2);
+
+    std::vector<TaskSharedPtr> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.push_back(std::make_shared<CountedTask>());
+    }
+    tasks.push_back(std::make_shared<ThrowingTask>());
+
+    for (const auto& task : tasks) {
+        pool->Submit(task);
+    }
+    for (const auto& task : tasks) {
+        task->Wait();
+    }
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stats = pool->GetStats();
+    EXPECT_EQ(stats.submitted, 11u);
+    EXPECT_EQ(stats.total.executed, 11u);
+    EXPECT_EQ(stats.total.failed, 1u);
+    EXPECT_EQ(stats.queue_depth, 0u);
+    ASSERT_EQ(stats.workers.size(), 2u);
+    EXPECT_EQ(stats.workers[0].executed + stats.workers[1].executed, 11u);
+}
+
+TEST(ExecutorStatsTest, CountsRequeuedAndCanceledTasks) {
+    auto pool = MakeThreadPoolExecutor(1);
+
+    auto task = std::make_shared<CountedTask>();
+    auto dependency = std::make_shared<CountedTask>();
+    task->AddDependency(dependency);
+
+    pool->Submit(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    dependency->Cancel();
+    task->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stats = pool->GetStats();
+    EXPECT_GT(stats.total.requeued, 0u);
+    EXPECT_EQ(stats.total.executed, 1u);
+}
+
+TEST(ExecutorStatsTest, CountsRejectedAfterShutdown) {
+    auto pool = MakeThreadPoolExecutor(1);
+    pool->StartShutdown();
+
+    auto task = std::make_shared<CountedTask>();
+    pool->Submit(task);
+    pool->WaitShutdown();
+
+    auto stats = pool->GetStats();
+    EXPECT_TRUE(task->IsCanceled());
+    EXPECT_EQ(stats.rejected, 1u);
+    EXPECT_EQ(stats.submitted, 0u);
+}
+
+TEST(ExecutorStatsTest, TracksIdleTimeAndParks) {
+    auto pool = MakeThreadPoolExecutor(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto task = std::make_shared<CountedTask>();
+    pool->Submit(task);
+    task->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stats = pool->GetStats();
+    EXPECT_GE(stats.total.parks, 1u);
+    EXPECT_GE(stats.total.unparks, 1u);
+    EXPECT_GE(stats.total.idle_time, std::chrono::milliseconds(10));
+}
+
+TEST(LatencyHistogramTest, BucketsCoverValues) {
+    for (uint64_t value : {0ull, 1ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull}) {
+        auto bucket = LatencyHistogram::BucketOf(value);
+        EXPECT_LE(LatencyHistogram::LowerBound(bucket), value);
+        EXPECT_GE(LatencyHistogram::UpperBound(bucket), value);
+    }
+    EXPECT_EQ(LatencyHistogram::BucketOf(~0ull), LatencyHistogram::kBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.Record(i * 1000);
+    }
+
+    HistogramSnapshot snapshot;
+    snapshot.Merge(histogram);
+
+    EXPECT_EQ(snapshot.Count(), 1000u);
+    EXPECT_EQ(snapshot.Max(), std::chrono::microseconds(1000));
+    EXPECT_NEAR(snapshot.P50().count(), 500'000, 500'000 / LatencyHistogram::kSubBuckets);
+    EXPECT_NEAR(snapshot.P99().count(), 990'000, 990'000 / LatencyHistogram::kSubBuckets);
+    EXPECT_LE(snapshot.P999(), snapshot.Max());
+    EXPECT_EQ(snapshot.Mean(), std::chrono::nanoseconds(500'500));
+}
+
+TEST(ExecutorStatsTest, RecordsLatencyHistograms) {
+    if (!kLatencyHistograms) {
+        GTEST_SKIP() << "Built without EXECUTORS_LATENCY_HISTOGRAMS";
+    }
+    auto pool = MakeThreadPoolExecutor(2);
+
+    auto task = std::make_shared<CountedTask>();
+    task->SetTimeTrigger(std::chrono::system_clock::now() + std::chrono::milliseconds(20));
+    auto slow = pool->Invoke<Unit>([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return Unit{};
+    });
+    pool->Submit(task);
+    task->Wait();
+    slow->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stats = pool->GetStats();
+    EXPECT_EQ(stats.run_time.Count(), 2u);
+    EXPECT_EQ(stats.queue_wait.Count(), 2u);
+    EXPECT_GE(stats.run_time.Max(), std::chrono::milliseconds(10));
+    EXPECT_LT(stats.queue_wait.Max(), std::chrono::milliseconds(10));
+}
+
+TEST(ExecutorStatsTest, CountsLockContention) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto before = pool->GetStats();
+
+    std::atomic<bool> started{false};
+    auto task = pool->Invoke<Unit>([&] {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        return Unit{};
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    // Run() executes under the task mutex, so Wait has to block on it
+    task->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto after = pool->GetStats();
+    EXPECT_GT(after.queue_lock.acquisitions, before.queue_lock.acquisitions);
+    EXPECT_GT(after.task_wait_lock.contended, before.task_wait_lock.contended);
+    EXPECT_GE(after.task_wait_lock.wait_time - before.task_wait_lock.wait_time,
+              std::chrono::milliseconds(20));
+}
+
+TEST(LockCountersTest, UncontendedLockIsNotCounted) {
+    std::mutex mutex;
+    LockCounters counters;
+    {
+        auto lock = LockProfiled(mutex, counters);
+        EXPECT_TRUE(lock.owns_lock());
+    }
+    LockStats stats;
+    stats.Load(counters);
+    EXPECT_EQ(stats.contended, 0u);
+    EXPECT_EQ(stats.wait_time.count(), 0);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "executors/executors.h"
+
+class TracedTask : public Task {
+public:
+    void Run() override {
+    }
+};
+
+TEST(TraceRingTest, KeepsNewestEvents) {
+    TraceRing ring(4);
+    for (uint64_t i = 0; i < 10; ++i) {
+        ring.Record({TraceEventType::Submit, 0, i, i, 0, nullptr});
+    }
+
+    std::vector<TraceEvent> events;
+    ring.Collect(&events);
+
+    ASSERT_EQ(events.size(), 4u);
+    for (const auto& event : events) {
+        EXPECT_GE(event.task_id, 6u);
+    }
+}
+
+TEST(TraceRingTest, WritersNeverShareSlots) {
+    TraceRing ring(8);
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> writers;
+    for (uint64_t thread = 0; thread < 4; ++thread) {
+        writers.emplace_back([&ring, &stop, thread] {
+            for (uint64_t i = 0; !stop; ++i) {
+                auto value = thread << 32 | i;
+                ring.Record({TraceEventType::Submit, thread, value, value, value, nullptr});
+            }
+        });
+    }
+    for (int round = 0; round < 1000; ++round) {
+        std::vector<TraceEvent> events;
+        ring.Collect(&events);
+        for (const auto& event : events) {
+            ASSERT_EQ(event.task_id >> 32, event.thread);
+            ASSERT_EQ(event.timestamp, event.task_id);
+            ASSERT_EQ(event.arg, event.task_id);
+        }
+    }
+    stop = true;
+    for (auto& writer : writers) {
+        writer.join();
+    }
+}
+
+TEST(TraceTest, DisabledByDefault) {
+    auto pool = MakeThreadPoolExecutor(1);
+    auto task = std::make_shared<TracedTask>();
+    pool->Submit(task);
+    task->Wait();
+
+    std::stringstream out;
+    pool->DumpTrace(out);
+    EXPECT_EQ(out.str().find("\"ph\":\"X\""), std::string::npos);
+}
+
+TEST(TraceTest, DumpsChromeTrace) {
+    auto pool = MakeThreadPoolExecutor(2, ExecutorOptions{.trace_capacity = 1024});
+
+    auto first = std::make_shared<TracedTask>();
+    auto second = std::make_shared<TracedTask>();
+    auto canceled = std::make_shared<TracedTask>();
+    first->SetLabel("first \"task\"\n\t\x01");
+    second->AddDependency(first);
+    canceled->AddDependency(second);
+
+    pool->Submit(second);
+    pool->Submit(canceled);
+    canceled->Cancel();
+    pool->Submit(first);
+    second->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    std::stringstream out;
+    pool->DumpTrace(out);
+    auto trace = out.str();
+
+    EXPECT_EQ(trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["), 0u);
+    EXPECT_NE(trace.find("\"name\":\"TracedTask\""), std::string::npos);
+    EXPECT_NE(trace.find(R"("name":"first \"task\"\n\t\u0001")"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"submit\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"cancel\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"s\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"f\""), std::string::npos);
+    EXPECT_NE(trace.find("\"args\":{\"id\":" + std::to_string(second->GetId()) + "}"),
+              std::string::npos);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "executors/executors.h"
+
+class StuckTask : public Task {
+public:
+    void Run() override {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::atomic<bool> release{false};
+};
+
+class NeverReadyTask : public Task {
+public:
+    void Run() override {
+    }
+};
+
+struct WatchdogTest : public ::testing::Test {
+    std::mutex mutex;
+    std::vector<StallReport> reports;
+
+    ExecutorOptions MakeOptions() {
+        ExecutorOptions options;
+        options.watchdog.period = std::chrono::milliseconds(5);
+        options.watchdog.running_threshold = std::chrono::milliseconds(20);
+        options.watchdog.pending_threshold = std::chrono::milliseconds(20);
+        options.watchdog.on_stall = [this](const StallReport& report) {
+            auto lock = std::scoped_lock{mutex};
+            reports.push_back(report);
+        };
+        return options;
+    }
+
+    std::vector<StallReport> Reports() {
+        auto lock = std::scoped_lock{mutex};
+        return reports;
+    }
+};
+
+TEST_F(WatchdogTest, ReportsLongRunningTaskOnce) {
+    auto pool = MakeThreadPoolExecutor(2, MakeOptions());
+    auto task = std::make_shared<StuckTask>();
+    task->SetLabel("stuck");
+    pool->Submit(task);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    task->release = true;
+    task->Wait();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stalls = Reports();
+    ASSERT_EQ(stalls.size(), 1u);
+    EXPECT_EQ(stalls[0].kind, StallReport::Kind::LongRunning);
+    EXPECT_EQ(stalls[0].task_id, task->GetId());
+    EXPECT_EQ(stalls[0].name, "stuck");
+    EXPECT_GE(stalls[0].age, std::chrono::milliseconds(20));
+    EXPECT_NE(stalls[0].thread, std::thread::id{});
+}
+
+TEST_F(WatchdogTest, ReportsNeverReadyTask) {
+    auto pool = MakeThreadPoolExecutor(1, MakeOptions());
+    auto task = std::make_shared<NeverReadyTask>();
+    auto never_submitted = std::make_shared<NeverReadyTask>();
+    task->AddDependency(never_submitted);
+    pool->Submit(task);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    task->Cancel();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    auto stalls = Reports();
+    ASSERT_FALSE(stalls.empty());
+    EXPECT_EQ(stalls[0].kind, StallReport::Kind::NeverReady);
+    EXPECT_EQ(stalls[0].task_id, task->GetId());
+    EXPECT_EQ(stalls[0].name, "NeverReadyTask");
+    EXPECT_EQ(stalls[0].unfinished_dependencies, 1u);
+}
+
+TEST_F(WatchdogTest, QuietForHealthyTasks) {
+    auto pool = MakeThreadPoolExecutor(2, MakeOptions());
+    for (int i = 0; i < 100; ++i) {
+        pool->Invoke<int>([i] { return i; })->Get();
+    }
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    EXPECT_TRUE(Reports().empty());
+}
+
+TEST_F(WatchdogTest, KeepsCheckingWhileTaskStallsInRun) {
+    auto pool = MakeThreadPoolExecutor(2, MakeOptions());
+    std::vector<std::shared_ptr<StuckTask>> stuck;
+    for (int i = 0; i < 4; ++i) {
+        stuck.push_back(std::make_shared<StuckTask>());
+        pool->Submit(stuck.back());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    auto task = std::make_shared<NeverReadyTask>();
+    task->AddDependency(std::make_shared<NeverReadyTask>());
+    pool->Submit(task);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto stalls = Reports();
+    for (auto& cur : stuck) {
+        cur->release = true;
+    }
+    task->Cancel();
+    pool->StartShutdown();
+    pool->WaitShutdown();
+
+    size_t long_running = 0;
+    bool never_ready = false;
+    for (const auto& report : stalls) {
+        long_running += report.kind == StallReport::Kind::LongRunning;
+        never_ready |= report.task_id == task->GetId();
+    }
+    EXPECT_EQ(long_running, 2u);
+    EXPECT_TRUE(never_ready);
+}